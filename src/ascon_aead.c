@@ -0,0 +1,546 @@
+///////////////////////////////////////////////////////////////////////////////
+// ascon_aead.c: C99 implementation and unit-test of ASCON128(a)/80pq AEAD.  //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+typedef union {
+  uint64_t x[5];
+  uint32_t w[5][2];
+  uint8_t b[5][8];
+} State;
+
+
+// The context of the streaming API holds the state, the key-words XORed to
+// x[1]-x[3] before the final permutation (`kpre`) and to x[2]-x[4] after the
+// initial and final permutation (`kpost`), the rate (8 bytes for ASCON128 and
+// ASCON80pq, 16 bytes for ASCON128a), the number of rounds of the
+// intermediate permutation, the number of bytes absorbed into the current
+// block, and the phase (associated data, message, or finished).
+
+typedef struct {
+  State s;
+  uint64_t kpre[3];
+  uint64_t kpost[3];
+  int rate;
+  int nrb;
+  int pos;
+  int phase;
+} AeadCtx;
+
+
+// variants
+#define ASCON128  0
+#define ASCON128A 1
+#define ASCON80PQ 2
+
+// initialization vectors
+#define IV128  0x80400c0600000000ULL
+#define IV128A 0x80800c0800000000ULL
+#define IV80PQ 0xa0400c0600000000ULL
+
+// phases of the streaming API
+#define PHASE_AD  0  // nothing but associated data has been absorbed yet
+#define PHASE_AD1 1  // at least one byte of associated data was absorbed
+#define PHASE_MSG 2  // associated data is padded, message is processed
+#define PHASE_END 3  // tag was computed, context must be re-initialized
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// load/store of a big-endian 64-bit word from/to an unaligned byte-array
+#define LOAD64(p) (((uint64_t) (p)[0] << 56) | ((uint64_t) (p)[1] << 48) | \
+  ((uint64_t) (p)[2] << 40) | ((uint64_t) (p)[3] << 32) | \
+  ((uint64_t) (p)[4] << 24) | ((uint64_t) (p)[5] << 16) | \
+  ((uint64_t) (p)[6] <<  8) | ((uint64_t) (p)[7]))
+#define LOAD32(p) (((uint32_t) (p)[0] << 24) | ((uint32_t) (p)[1] << 16) | \
+  ((uint32_t) (p)[2] <<  8) | ((uint32_t) (p)[3]))
+#define STORE64(p, x) do { (p)[0] = (uint8_t) ((x) >> 56); \
+  (p)[1] = (uint8_t) ((x) >> 48); (p)[2] = (uint8_t) ((x) >> 40); \
+  (p)[3] = (uint8_t) ((x) >> 32); (p)[4] = (uint8_t) ((x) >> 24); \
+  (p)[5] = (uint8_t) ((x) >> 16); (p)[6] = (uint8_t) ((x) >>  8); \
+  (p)[7] = (uint8_t) (x); } while (0)
+
+// i-th byte of the rate-part of the state in big-endian order (ASCON is
+// specified big-endian, the host is little-endian like MSP430, AVR and x86)
+#define SBYTE(s, i) ((s)->b[(i) >> 3][7 ^ ((i) & 7)])
+
+
+extern void ascon_c99_pn(State *s, int nr);
+extern void ascon_c99_p12k(State *s, const uint64_t *kpre,
+  const uint64_t *kpost);
+extern void ascon_c99_absorb(State *s, int nr, const UChar *in, int nw);
+extern void ascon_c99_encrypt(State *s, int nr, const UChar *in, int nw,
+  UChar *out);
+extern void ascon_c99_decrypt(State *s, int nr, const UChar *in, int nw,
+  UChar *out);
+
+#if (defined(__AVR) || defined(__AVR__))
+extern void ascon_avr(State *s, int nr);
+#define ascon_asm(s, nr) ascon_avr((s), (nr))
+#define ASCON_ASSEMBLER
+#endif
+
+#if (defined(__MSP430__) || defined(__ICC430__))
+extern void ascon_msp(State *s, int nr);
+extern void ascon_msp_p12k(State *s, const uint64_t *kpre,
+  const uint64_t *kpost);
+#define ascon_asm(s, nr) ascon_msp((s), (nr))
+extern void ascon_msp_absorb(State *s, int nr, const UChar *in, int nw);
+extern void ascon_msp_encrypt(State *s, int nr, const UChar *in, int nw,
+  UChar *out);
+extern void ascon_msp_decrypt(State *s, int nr, const UChar *in, int nw,
+  UChar *out);
+#define ascon_asm_p12k(s, kpre, kpost) ascon_msp_p12k((s), (kpre), (kpost))
+#define ascon_asm_absorb(s, nr, in, nw) \
+  ascon_msp_absorb((s), (nr), (in), (nw))
+#define ascon_asm_encrypt(s, nr, in, nw, out) \
+  ascon_msp_encrypt((s), (nr), (in), (nw), (out))
+#define ascon_asm_decrypt(s, nr, in, nw, out) \
+  ascon_msp_decrypt((s), (nr), (in), (nw), (out))
+#define ASCON_ASSEMBLER
+#endif
+
+// the mode uses the Assembler permutation when available, otherwise the
+// unrolled C99 specializations from ascon_perm.c
+#if defined(ASCON_ASSEMBLER)
+#define ASCON_PERM(s, nr) ascon_asm((s), (nr))
+#else
+#define ASCON_PERM(s, nr) ascon_c99_pn((s), (nr))
+#endif
+#if defined(ascon_asm_p12k)
+#define ASCON_P12K(s, kpre, kpost) ascon_asm_p12k((s), (kpre), (kpost))
+#else
+#define ASCON_P12K(s, kpre, kpost) ascon_c99_p12k((s), (kpre), (kpost))
+#endif
+// full blocks are processed with the fused absorb-and-permute kernels; when
+// there is an Assembler permutation but no fused kernels (AVR), the rate-words
+// are processed in C before the permutation is called
+#if defined(ascon_asm_encrypt)
+#define ASCON_ABSORB(s, nr, in, nw) ascon_asm_absorb(s, nr, in, nw)
+#define ASCON_ENCRYPT(s, nr, in, nw, out) ascon_asm_encrypt(s, nr, in, nw, out)
+#define ASCON_DECRYPT(s, nr, in, nw, out) ascon_asm_decrypt(s, nr, in, nw, out)
+#elif defined(ASCON_ASSEMBLER)
+#define ASCON_ABSORB(s, nr, in, nw) do { int i_; \
+  for (i_ = 0; i_ < (nw); i_++) (s)->x[i_] ^= LOAD64((in) + 8*i_); \
+  ascon_asm((s), (nr)); } while (0)
+#define ASCON_ENCRYPT(s, nr, in, nw, out) do { int i_; \
+  for (i_ = 0; i_ < (nw); i_++) { (s)->x[i_] ^= LOAD64((in) + 8*i_); \
+    STORE64((out) + 8*i_, (s)->x[i_]); } \
+  ascon_asm((s), (nr)); } while (0)
+#define ASCON_DECRYPT(s, nr, in, nw, out) do { int i_; uint64_t w_; \
+  for (i_ = 0; i_ < (nw); i_++) { w_ = LOAD64((in) + 8*i_); \
+    (s)->x[i_] ^= w_; STORE64((out) + 8*i_, (s)->x[i_]); (s)->x[i_] = w_; } \
+  ascon_asm((s), (nr)); } while (0)
+#else
+#define ASCON_ABSORB(s, nr, in, nw) ascon_c99_absorb(s, nr, in, nw)
+#define ASCON_ENCRYPT(s, nr, in, nw, out) ascon_c99_encrypt(s, nr, in, nw, out)
+#define ASCON_DECRYPT(s, nr, in, nw, out) ascon_c99_decrypt(s, nr, in, nw, out)
+#endif
+
+
+// Initialization of the streaming API: loads key and nonce into the state
+// and executes the 12-round permutation. The `variant` is either ASCON128,
+// ASCON128A, or ASCON80PQ; the key has a length of 16 bytes for the former
+// two and 20 bytes for ASCON80pq. The key-words for the fused key additions
+// are computed only once here, i.e. the key is not re-loaded in finalization.
+
+void ascon_aead_init(AeadCtx *ctx, const UChar *key, const UChar *npub,
+  int variant)
+{
+  State *s = &ctx->s;
+  uint64_t k0 = LOAD64(key), k1 = LOAD64(key + 8);
+
+  ctx->rate = (variant == ASCON128A) ? 16 : 8;
+  ctx->nrb = (variant == ASCON128A) ? 8 : 6;
+  ctx->pos = 0;
+  ctx->phase = PHASE_AD;
+
+  if (variant == ASCON80PQ) {
+    // the 160-bit key occupies the lower half of x[0] and the words x[1]
+    // and x[2], i.e. it is not aligned to the 64-bit state-words
+    ctx->kpre[0] = k0;
+    ctx->kpre[1] = k1;
+    ctx->kpre[2] = (uint64_t) LOAD32(key + 16) << 32;
+    ctx->kpost[0] = LOAD32(key);
+    ctx->kpost[1] = LOAD64(key + 4);
+    ctx->kpost[2] = LOAD64(key + 12);
+    s->x[0] = IV80PQ | ctx->kpost[0];
+    s->x[1] = ctx->kpost[1];
+    s->x[2] = ctx->kpost[2];
+  } else {
+    // the 128-bit key is XORed to the first two words of the capacity
+    ctx->kpre[0] = (variant == ASCON128A) ? 0 : k0;
+    ctx->kpre[1] = (variant == ASCON128A) ? k0 : k1;
+    ctx->kpre[2] = (variant == ASCON128A) ? k1 : 0;
+    ctx->kpost[0] = 0;
+    ctx->kpost[1] = k0;
+    ctx->kpost[2] = k1;
+    s->x[0] = (variant == ASCON128A) ? IV128A : IV128;
+    s->x[1] = k0;
+    s->x[2] = k1;
+  }
+  s->x[3] = LOAD64(npub);
+  s->x[4] = LOAD64(npub + 8);
+  ASCON_P12K(s, NULL, ctx->kpost);
+}
+
+
+// Absorption of associated data, which can be split up into an arbitrary
+// number of chunks of arbitrary length. A full block is permuted as soon as
+// its last byte arrives because the padding always goes into a further block.
+
+void ascon_aead_update_ad(AeadCtx *ctx, const UChar *ad, size_t adlen)
+{
+  State *s = &ctx->s;
+  int rate = ctx->rate, pos = ctx->pos;
+
+  if (adlen == 0) return;
+  ctx->phase = PHASE_AD1;
+
+  // complete a partially filled block
+  while ((pos > 0) && (adlen > 0)) {
+    SBYTE(s, pos) ^= *ad++;
+    adlen--;
+    if (++pos == rate) {
+      ASCON_PERM(s, ctx->nrb);
+      pos = 0;
+    }
+  }
+  // full blocks are absorbed word-wise
+  while (adlen >= (size_t) rate) {
+    ASCON_ABSORB(s, ctx->nrb, ad, rate >> 3);
+    ad += rate;
+    adlen -= rate;
+  }
+  // remaining bytes are buffered in the state
+  while (adlen > 0) {
+    SBYTE(s, pos) ^= *ad++;
+    adlen--;
+    pos++;
+  }
+
+  ctx->pos = pos;
+}
+
+
+// Padding of the associated data and domain separation. This function is
+// called implicitly by the first message update or the finalization.
+
+static void ascon_aead_finish_ad(AeadCtx *ctx)
+{
+  State *s = &ctx->s;
+
+  if (ctx->phase == PHASE_AD1) {
+    SBYTE(s, ctx->pos) ^= 0x80;
+    ASCON_PERM(s, ctx->nrb);
+  }
+  s->x[4] ^= 1;
+  ctx->pos = 0;
+  ctx->phase = PHASE_MSG;
+}
+
+
+// Encryption of a chunk of the message. The ciphertext `c` may be the same
+// buffer as the plaintext `m` (in-place encryption), but the two must not
+// overlap otherwise.
+
+void ascon_aead_enc_update(AeadCtx *ctx, UChar *c, const UChar *m,
+  size_t mlen)
+{
+  State *s = &ctx->s;
+  int rate = ctx->rate, pos;
+
+  if (ctx->phase < PHASE_MSG) ascon_aead_finish_ad(ctx);
+  pos = ctx->pos;
+
+  while ((pos > 0) && (mlen > 0)) {
+    SBYTE(s, pos) ^= *m++;
+    *c++ = SBYTE(s, pos);
+    mlen--;
+    if (++pos == rate) {
+      ASCON_PERM(s, ctx->nrb);
+      pos = 0;
+    }
+  }
+  while (mlen >= (size_t) rate) {
+    ASCON_ENCRYPT(s, ctx->nrb, m, rate >> 3, c);
+    m += rate;
+    c += rate;
+    mlen -= rate;
+  }
+  while (mlen > 0) {
+    SBYTE(s, pos) ^= *m++;
+    *c++ = SBYTE(s, pos);
+    mlen--;
+    pos++;
+  }
+
+  ctx->pos = pos;
+}
+
+
+// Decryption of a chunk of the ciphertext, which can be done in-place like
+// the encryption. Note that the plaintext is released before the tag has
+// been verified; a caller must discard it when ascon_aead_dec_final fails.
+
+void ascon_aead_dec_update(AeadCtx *ctx, UChar *m, const UChar *c,
+  size_t clen)
+{
+  State *s = &ctx->s;
+  int rate = ctx->rate, pos;
+  UChar cb;
+
+  if (ctx->phase < PHASE_MSG) ascon_aead_finish_ad(ctx);
+  pos = ctx->pos;
+
+  while ((pos > 0) && (clen > 0)) {
+    cb = *c++;
+    *m++ = SBYTE(s, pos) ^ cb;
+    SBYTE(s, pos) = cb;
+    clen--;
+    if (++pos == rate) {
+      ASCON_PERM(s, ctx->nrb);
+      pos = 0;
+    }
+  }
+  while (clen >= (size_t) rate) {
+    ASCON_DECRYPT(s, ctx->nrb, c, rate >> 3, m);
+    m += rate;
+    c += rate;
+    clen -= rate;
+  }
+  while (clen > 0) {
+    cb = *c++;
+    *m++ = SBYTE(s, pos) ^ cb;
+    SBYTE(s, pos) = cb;
+    clen--;
+    pos++;
+  }
+
+  ctx->pos = pos;
+}
+
+
+// Padding of the last message block and finalization, which writes the
+// 128-bit tag to the state-words x[3] and x[4]. The key addition to x[2] in
+// the case of ASCON80pq does not affect the tag.
+
+static void ascon_aead_finalize(AeadCtx *ctx)
+{
+  State *s = &ctx->s;
+
+  if (ctx->phase < PHASE_MSG) ascon_aead_finish_ad(ctx);
+  SBYTE(s, ctx->pos) ^= 0x80;
+  ASCON_P12K(s, ctx->kpre, ctx->kpost);
+  ctx->phase = PHASE_END;
+}
+
+
+void ascon_aead_enc_final(AeadCtx *ctx, UChar *tag)
+{
+  ascon_aead_finalize(ctx);
+  STORE64(tag, ctx->s.x[3]);
+  STORE64(tag + 8, ctx->s.x[4]);
+}
+
+
+// Finalization of the decryption. The tag is compared in constant time; the
+// return value is 0 if the tag is valid and -1 otherwise.
+
+int ascon_aead_dec_final(AeadCtx *ctx, const UChar *tag)
+{
+  uint64_t diff;
+
+  ascon_aead_finalize(ctx);
+  diff = ctx->s.x[3] ^ LOAD64(tag);
+  diff |= ctx->s.x[4] ^ LOAD64(tag + 8);
+  diff |= diff >> 32;
+  diff |= diff >> 16;
+  diff |= diff >> 8;
+
+  return -(int) (((diff & 0xff) + 0xff) >> 8);
+}
+
+
+// One-shot encryption of a short packet. Ciphertext and plaintext may be the
+// same buffer. In contrast to the NIST API, the tag is written into a buffer
+// of its own so that `c` does not have to be larger than `m`.
+
+void ascon_aead_encrypt(UChar *c, UChar *tag, const UChar *m, size_t mlen,
+  const UChar *ad, size_t adlen, const UChar *npub, const UChar *key,
+  int variant)
+{
+  AeadCtx ctx;
+
+  ascon_aead_init(&ctx, key, npub, variant);
+  ascon_aead_update_ad(&ctx, ad, adlen);
+  ascon_aead_enc_update(&ctx, c, m, mlen);
+  ascon_aead_enc_final(&ctx, tag);
+}
+
+
+// One-shot decryption of a short packet. If the tag is invalid, the output
+// buffer is cleared and -1 is returned.
+
+int ascon_aead_decrypt(UChar *m, const UChar *c, size_t clen,
+  const UChar *tag, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant)
+{
+  AeadCtx ctx;
+  int res;
+
+  ascon_aead_init(&ctx, key, npub, variant);
+  ascon_aead_update_ad(&ctx, ad, adlen);
+  ascon_aead_dec_update(&ctx, m, c, clen);
+  res = ascon_aead_dec_final(&ctx, tag);
+  if (res != 0) memset(m, 0, clen);
+
+  return res;
+}
+
+
+// Print a byte-array in Hex format (the output is limited to the first 64
+// bytes of the byte-array).
+
+static void print_bytes(const char* str, const UChar *bytearray, size_t len)
+{
+  UChar buffer[148], byte;
+  size_t i, j, slen = 0;
+
+  if (str != NULL) {
+    slen = MIN(16, strlen(str));
+    memcpy(buffer, str, slen);
+  }
+
+  j = slen;
+  for (i = 0; i < MIN(64, len); i++) {
+    byte = bytearray[i] >> 4;
+    // replace 87 by 55 to get uppercase letters
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+    byte = bytearray[i] & 0xf;
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+  }
+  if (len > 64) {
+    buffer[j] = buffer[j+1] = buffer[j+2] = '.';
+    j += 3;
+  }
+  buffer[j] = '\0';
+
+  printf("%s\n", buffer);
+}
+
+
+// Simple test function for the ASCON128(a) and ASCON80pq AEAD. The 1st test
+// uses the key, nonce, and associated data of the NIST KAT files with an
+// empty message, the 2nd test encrypts a 41-byte message (in place) in chunks
+// of 1, 7, and 33 bytes and decrypts it with the one-shot function, and the
+// 3rd test checks that a tampered ciphertext is rejected.
+
+void ascon_test_aead(int variant)
+{
+  UChar key[20], npub[16], ad[32], buf[48], tag[16];
+  AeadCtx ctx;
+  int i, res;
+
+  for (i = 0; i < 20; i++) key[i] = (UChar) i;
+  for (i = 0; i < 16; i++) npub[i] = (UChar) i;
+  for (i = 0; i < 32; i++) ad[i] = (UChar) i;
+  memset(buf, 0, sizeof(buf));
+
+  // 1st test: empty message, empty and 1-byte associated data
+
+  printf("Test 1 - C99 implementation:\n");
+  ascon_aead_encrypt(buf, tag, buf, 0, ad, 0, npub, key, variant);
+  print_bytes("Tag: ", tag, 16);
+  ascon_aead_encrypt(buf, tag, buf, 0, ad, 1, npub, key, variant);
+  print_bytes("Tag: ", tag, 16);
+
+  // 2nd test: streaming in-place encryption and one-shot decryption
+
+  printf("Test 2 - C99 implementation:\n");
+  for (i = 0; i < 41; i++) buf[i] = (UChar) i;
+  ascon_aead_init(&ctx, key, npub, variant);
+  ascon_aead_update_ad(&ctx, ad, 3);
+  ascon_aead_update_ad(&ctx, ad + 3, 29);
+  ascon_aead_enc_update(&ctx, buf, buf, 1);
+  ascon_aead_enc_update(&ctx, buf + 1, buf + 1, 7);
+  ascon_aead_enc_update(&ctx, buf + 8, buf + 8, 33);
+  ascon_aead_enc_final(&ctx, tag);
+  print_bytes("CT:  ", buf, 41);
+  print_bytes("Tag: ", tag, 16);
+  res = ascon_aead_decrypt(buf, buf, 41, tag, ad, 32, npub, key, variant);
+  print_bytes("PT:  ", buf, 41);
+  printf("Verification: %s\n", (res == 0) ? "ok" : "failed");
+
+  // 3rd test: a flipped bit in the ciphertext must be detected
+
+  printf("Test 3 - C99 implementation:\n");
+  ascon_aead_encrypt(buf, tag, buf, 41, ad, 32, npub, key, variant);
+  buf[40] ^= 0x01;
+  res = ascon_aead_decrypt(buf, buf, 41, tag, ad, 32, npub, key, variant);
+  printf("Verification: %s\n", (res == 0) ? "ok" : "failed");
+  print_bytes("PT:  ", buf, 41);
+
+  // Expected result for ASCON128
+  // ----------------------------
+  // Test 1 - C99 implementation:
+  // Tag: e355159f292911f794cb1432a0103a8a
+  // Tag: 944df887cd4901614c5dedbc42fc0da0
+  // Test 2 - C99 implementation:
+  // CT:  b96c78651b6246b0c3b1a5d373b0d5168dca4a96734cf0ddf5f92f8d15e30270e5946054bd241d5bfe
+  // Tag: aa0f153acda565656ef31305b04a2bec
+  // PT:  000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728
+  // Verification: ok
+  // Test 3 - C99 implementation:
+  // Verification: failed
+  // PT:  0000000000000000000000000000000000000000000000000000000000000000000000000000000000
+
+  // Expected result for ASCON128a
+  // -----------------------------
+  // Test 1 - C99 implementation:
+  // Tag: 7a834e6f09210957067b10fd831f0078
+  // Tag: af3031b07b129ec84153373ddcaba528
+  // Test 2 - C99 implementation:
+  // CT:  a55236ac020dbda74ce6ccd10c68c4d8514450a382bc87c68946d86a921dd88e0a4e103dab46c562f9
+  // Tag: 0deb4fcfbe88a68efa5c8917a1c5844d
+  // PT:  000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728
+  // Verification: ok
+  // Test 3 - C99 implementation:
+  // Verification: failed
+  // PT:  0000000000000000000000000000000000000000000000000000000000000000000000000000000000
+
+  // Expected result for ASCON80pq
+  // -----------------------------
+  // Test 1 - C99 implementation:
+  // Tag: abb688efa0b9d56b33277a2c97d2146b
+  // Tag: a259d760e87b0ca73002c3a01e69b567
+  // Test 2 - C99 implementation:
+  // CT:  cc4e07e5fb13426effd17b0f51a6a830bf484c9651d77679971e8eb4a8edb5a0efa69f749d6a2784eb
+  // Tag: a969660d3e70c730ca489e56a39b1b35
+  // PT:  000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728
+  // Verification: ok
+  // Test 3 - C99 implementation:
+  // Verification: failed
+  // PT:  0000000000000000000000000000000000000000000000000000000000000000000000000000000000
+}
@@ -0,0 +1,330 @@
+///////////////////////////////////////////////////////////////////////////////
+// ascon_hash.c: C99 implementation and unit-test of ASCON-Hash(a)/XOF(a).   //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+typedef union {
+  uint64_t x[5];
+  uint32_t w[5][2];
+  uint8_t b[5][8];
+} State;
+
+
+// The context of the streaming API holds the state, the number of rounds of
+// the intermediate permutation (12 for ASCON-Hash/XOF, 8 for the variants
+// ASCON-Hasha/XOFa), the number of bytes absorbed into or squeezed from the
+// current block, and a flag indicating the squeezing phase.
+
+typedef struct {
+  State s;
+  int nrb;
+  int pos;
+  int squeezing;
+} HashCtx;
+
+
+// variants
+#define ASCON_HASH  0
+#define ASCON_HASHA 1
+#define ASCON_XOF   2
+#define ASCON_XOFA  3
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// load/store of a big-endian 64-bit word from/to an unaligned byte-array
+#define LOAD64(p) (((uint64_t) (p)[0] << 56) | ((uint64_t) (p)[1] << 48) | \
+  ((uint64_t) (p)[2] << 40) | ((uint64_t) (p)[3] << 32) | \
+  ((uint64_t) (p)[4] << 24) | ((uint64_t) (p)[5] << 16) | \
+  ((uint64_t) (p)[6] <<  8) | ((uint64_t) (p)[7]))
+#define STORE64(p, x) do { (p)[0] = (uint8_t) ((x) >> 56); \
+  (p)[1] = (uint8_t) ((x) >> 48); (p)[2] = (uint8_t) ((x) >> 40); \
+  (p)[3] = (uint8_t) ((x) >> 32); (p)[4] = (uint8_t) ((x) >> 24); \
+  (p)[5] = (uint8_t) ((x) >> 16); (p)[6] = (uint8_t) ((x) >>  8); \
+  (p)[7] = (uint8_t) (x); } while (0)
+
+// i-th byte of the rate-word x[0] in big-endian order (ASCON is specified
+// big-endian, the host is little-endian like MSP430, AVR and x86)
+#define SBYTE(s, i) ((s)->b[0][7 ^ (i)])
+
+
+extern void ascon_c99_pn(State *s, int nr);
+extern void ascon_c99_absorb(State *s, int nr, const UChar *in, int nw);
+
+#if (defined(__AVR) || defined(__AVR__))
+extern void ascon_avr(State *s, int nr);
+#define ascon_asm(s, nr) ascon_avr((s), (nr))
+#define ASCON_ASSEMBLER
+#endif
+
+#if (defined(__MSP430__) || defined(__ICC430__))
+extern void ascon_msp(State *s, int nr);
+extern void ascon_msp_absorb(State *s, int nr, const UChar *in, int nw);
+#define ascon_asm(s, nr) ascon_msp((s), (nr))
+#define ascon_asm_absorb(s, nr, in, nw) \
+  ascon_msp_absorb((s), (nr), (in), (nw))
+#define ASCON_ASSEMBLER
+#endif
+
+// the mode uses the Assembler permutation when available, otherwise the
+// unrolled C99 specializations from ascon_perm.c
+#if defined(ASCON_ASSEMBLER)
+#define ASCON_PERM(s, nr) ascon_asm((s), (nr))
+#else
+#define ASCON_PERM(s, nr) ascon_c99_pn((s), (nr))
+#endif
+// full blocks are absorbed with the fused absorb-and-permute kernel (AVR has
+// no such kernel, the block is XORed in C before the permutation is called)
+#if defined(ascon_asm_absorb)
+#define ASCON_ABSORB(s, nr, in) ascon_asm_absorb((s), (nr), (in), 1)
+#elif defined(ASCON_ASSEMBLER)
+#define ASCON_ABSORB(s, nr, in) do { (s)->x[0] ^= LOAD64(in); \
+  ascon_asm((s), (nr)); } while (0)
+#else
+#define ASCON_ABSORB(s, nr, in) ascon_c99_absorb((s), (nr), (in), 1)
+#endif
+
+
+// The initial state of each variant, i.e. the IV in x[0] (followed by four
+// all-0 words) after the 12-round permutation. Using these precomputed words
+// saves one permutation call per hash.
+
+static const uint64_t ivstate[4][5] = {
+  { 0xee9398aadb67f03dULL, 0x8bb21831c60f1002ULL, 0xb48a92db98d5da62ULL,
+    0x43189921b8f8e3e8ULL, 0x348fa5c9d525e140ULL },  // IV 0x00400c0000000100
+  { 0x01470194fc6528a6ULL, 0x738ec38ac0adffa7ULL, 0x2ec8e3296c76384cULL,
+    0xd6f6a54d7f52377dULL, 0xa13c42a223be8d87ULL },  // IV 0x00400c0400000100
+  { 0xb57e273b814cd416ULL, 0x2b51042562ae2420ULL, 0x66a3a7768ddf2218ULL,
+    0x5aad0a7a8153650cULL, 0x4f3e0e32539493b6ULL },  // IV 0x00400c0000000000
+  { 0x44906568b77b9832ULL, 0xcd8d6cae53455532ULL, 0xf7b5212756422129ULL,
+    0x246885e1de0d225bULL, 0xa8cb5ce33449973fULL }   // IV 0x00400c0400000000
+};
+
+
+// Initialization of the streaming API. The `variant` is one of ASCON_HASH,
+// ASCON_HASHA, ASCON_XOF, or ASCON_XOFA.
+
+void ascon_hash_init(HashCtx *ctx, int variant)
+{
+  memcpy(ctx->s.x, ivstate[variant & 3], sizeof(ctx->s.x));
+  ctx->nrb = (variant & 1) ? 8 : 12;
+  ctx->pos = 0;
+  ctx->squeezing = 0;
+}
+
+
+// Absorption of a chunk of the message; the message can be split up into an
+// arbitrary number of chunks of arbitrary length. A full block is permuted as
+// soon as its last byte arrives because the padding always goes into a
+// further block.
+
+void ascon_hash_update(HashCtx *ctx, const UChar *in, size_t inlen)
+{
+  State *s = &ctx->s;
+  int pos = ctx->pos;
+
+  while ((pos > 0) && (inlen > 0)) {
+    SBYTE(s, pos) ^= *in++;
+    inlen--;
+    if (++pos == 8) {
+      ASCON_PERM(s, ctx->nrb);
+      pos = 0;
+    }
+  }
+  while (inlen >= 8) {
+    ASCON_ABSORB(s, ctx->nrb, in);
+    in += 8;
+    inlen -= 8;
+  }
+  while (inlen > 0) {
+    SBYTE(s, pos) ^= *in++;
+    inlen--;
+    pos++;
+  }
+
+  ctx->pos = pos;
+}
+
+
+// Squeezing of `outlen` bytes. The first call pads the last message block and
+// executes the 12-round permutation; any further call continues the output
+// stream of the XOF. Full 8-byte blocks are written directly to the caller's
+// buffer and the state is permuted lazily, i.e. only when more output is
+// requested, so no permutation is wasted after the last block.
+
+void ascon_hash_squeeze(HashCtx *ctx, UChar *out, size_t outlen)
+{
+  State *s = &ctx->s;
+  int pos = ctx->pos;
+
+  if (!ctx->squeezing) {
+    SBYTE(s, pos) ^= 0x80;
+    ASCON_PERM(s, 12);
+    ctx->squeezing = 1;
+    pos = 0;
+  }
+
+  while ((pos > 0) && (outlen > 0)) {
+    if (pos == 8) {
+      ASCON_PERM(s, ctx->nrb);
+      pos = 0;
+      break;
+    }
+    *out++ = SBYTE(s, pos);
+    outlen--;
+    pos++;
+  }
+  while (outlen >= 8) {
+    if (pos == 8) ASCON_PERM(s, ctx->nrb);
+    STORE64(out, s->x[0]);
+    out += 8;
+    outlen -= 8;
+    pos = 8;
+  }
+  if (outlen > 0) {
+    if (pos == 8) ASCON_PERM(s, ctx->nrb);
+    pos = 0;
+    while (outlen > 0) {
+      *out++ = SBYTE(s, pos);
+      outlen--;
+      pos++;
+    }
+  }
+
+  ctx->pos = pos;
+}
+
+
+// One-shot computation of the 256-bit digest of ASCON-Hash (`variant` is
+// ASCON_HASH) or ASCON-Hasha (`variant` is ASCON_HASHA).
+
+void ascon_hash(UChar *out, const UChar *in, size_t inlen, int variant)
+{
+  HashCtx ctx;
+
+  ascon_hash_init(&ctx, variant);
+  ascon_hash_update(&ctx, in, inlen);
+  ascon_hash_squeeze(&ctx, out, 32);
+}
+
+
+// One-shot computation of an output of arbitrary length with ASCON-XOF
+// (`variant` is ASCON_XOF) or ASCON-XOFa (`variant` is ASCON_XOFA).
+
+void ascon_xof(UChar *out, size_t outlen, const UChar *in, size_t inlen,
+  int variant)
+{
+  HashCtx ctx;
+
+  ascon_hash_init(&ctx, variant);
+  ascon_hash_update(&ctx, in, inlen);
+  ascon_hash_squeeze(&ctx, out, outlen);
+}
+
+
+// Print a byte-array in Hex format (the output is limited to the first 64
+// bytes of the byte-array).
+
+static void print_bytes(const char* str, const UChar *bytearray, size_t len)
+{
+  UChar buffer[148], byte;
+  size_t i, j, slen = 0;
+
+  if (str != NULL) {
+    slen = MIN(16, strlen(str));
+    memcpy(buffer, str, slen);
+  }
+
+  j = slen;
+  for (i = 0; i < MIN(64, len); i++) {
+    byte = bytearray[i] >> 4;
+    // replace 87 by 55 to get uppercase letters
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+    byte = bytearray[i] & 0xf;
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+  }
+  if (len > 64) {
+    buffer[j] = buffer[j+1] = buffer[j+2] = '.';
+    j += 3;
+  }
+  buffer[j] = '\0';
+
+  printf("%s\n", buffer);
+}
+
+
+// Simple test function for ASCON-Hash(a) and ASCON-XOF(a). The 1st test
+// hashes the empty message with all four variants (the results are the first
+// entries of the NIST KAT files), the 2nd test absorbs a 45-byte message in
+// chunks of 1, 11, and 33 bytes and squeezes 45 bytes from the XOF in chunks
+// of 3, 8, 16, and 18 bytes, which must be the same as the one-shot output.
+
+void ascon_test_hash(void)
+{
+  UChar msg[48], out[48], out2[48];
+  HashCtx ctx;
+  int i;
+
+  for (i = 0; i < 48; i++) msg[i] = (UChar) i;
+
+  // 1st test: empty message
+
+  printf("Test 1 - C99 implementation:\n");
+  ascon_hash(out, msg, 0, ASCON_HASH);
+  print_bytes("Hash:  ", out, 32);
+  ascon_hash(out, msg, 0, ASCON_HASHA);
+  print_bytes("Hasha: ", out, 32);
+  ascon_xof(out, 32, msg, 0, ASCON_XOF);
+  print_bytes("XOF:   ", out, 32);
+  ascon_xof(out, 32, msg, 0, ASCON_XOFA);
+  print_bytes("XOFa:  ", out, 32);
+
+  // 2nd test: streaming absorb and squeeze
+
+  printf("Test 2 - C99 implementation:\n");
+  ascon_xof(out, 45, msg, 45, ASCON_XOF);
+  print_bytes("XOF:   ", out, 45);
+  ascon_hash_init(&ctx, ASCON_XOF);
+  ascon_hash_update(&ctx, msg, 1);
+  ascon_hash_update(&ctx, msg + 1, 11);
+  ascon_hash_update(&ctx, msg + 12, 33);
+  ascon_hash_squeeze(&ctx, out2, 3);
+  ascon_hash_squeeze(&ctx, out2 + 3, 8);
+  ascon_hash_squeeze(&ctx, out2 + 11, 16);
+  ascon_hash_squeeze(&ctx, out2 + 27, 18);
+  print_bytes("XOF:   ", out2, 45);
+  printf("Streaming output %s\n", memcmp(out, out2, 45) ? "differs" : "ok");
+
+  // Expected result
+  // ---------------
+  // Test 1 - C99 implementation:
+  // Hash:  7346bc14f036e87ae03d0997913088f5f68411434b3cf8b54fa796a80d251f91
+  // Hasha: aecd027026d0675f9de7a8ad8ccf512db64b1edcf0b20c388a0c7cc617aaa2c4
+  // XOF:   5d4cbde6350ea4c174bd65b5b332f8408f99740b81aa02735eaefbcf0ba0339e
+  // XOFa:  7c10dffd6bb03be262d72fbe1b0f530013c6c4eadaabde278d6f29d579e3908d
+  // Test 2 - C99 implementation:
+  // XOF:   0228f290b9ae7fb40dde771b133a1ba66b2ef51bd41f6b4f80faa86d7f9d8b4cff12e0902422f7b8b1bf933e3f
+  // XOF:   0228f290b9ae7fb40dde771b133a1ba66b2ef51bd41f6b4f80faa86d7f9d8b4cff12e0902422f7b8b1bf933e3f
+  // Streaming output ok
+}
@@ -0,0 +1,583 @@
+///////////////////////////////////////////////////////////////////////////////
+// ascon_mb.c: Multi-buffer job manager and unit-test of ASCON128(a) AEAD.   //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+typedef union {
+  uint64_t x[5];
+  uint32_t w[5][2];
+  uint8_t b[5][8];
+} State;
+
+
+// number of lanes of the job manager, i.e. the number of states that are
+// permuted in one call of ascon_multi (a multiple of the SIMD width)
+#if defined(__AVX512F__)
+#define MB_LANES 8
+#else
+#define MB_LANES 4
+#endif
+
+// variants (same values as in ascon_aead.c)
+#define ASCON128  0
+#define ASCON128A 1
+
+// status of a job
+#define MB_JOB_NEW  0  // job was not yet submitted
+#define MB_JOB_BUSY 1  // job occupies a lane of the manager
+#define MB_JOB_DONE 2  // job is complete (and the tag is valid)
+#define MB_JOB_FAIL 3  // decryption job with invalid tag, output is cleared
+
+// phases of a lane; each phase ends with exactly one permutation call
+#define PHASE_INIT   0  // initialization (12 rounds)
+#define PHASE_AD     1  // full block of associated data (intermediate rounds)
+#define PHASE_ADLAST 2  // padded last block of associated data
+#define PHASE_MSG    3  // full block of the message
+#define PHASE_FINAL  4  // padded last block of the message (12 rounds)
+
+// initialization vectors of ASCON128 and ASCON128a
+#define IV128  0x80400c0600000000ULL
+#define IV128A 0x80800c0800000000ULL
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// load/store of a big-endian 64-bit word from/to an unaligned byte-array
+#define LOAD64(p) (((uint64_t) (p)[0] << 56) | ((uint64_t) (p)[1] << 48) | \
+  ((uint64_t) (p)[2] << 40) | ((uint64_t) (p)[3] << 32) | \
+  ((uint64_t) (p)[4] << 24) | ((uint64_t) (p)[5] << 16) | \
+  ((uint64_t) (p)[6] <<  8) | ((uint64_t) (p)[7]))
+#define STORE64(p, x) do { (p)[0] = (uint8_t) ((x) >> 56); \
+  (p)[1] = (uint8_t) ((x) >> 48); (p)[2] = (uint8_t) ((x) >> 40); \
+  (p)[3] = (uint8_t) ((x) >> 32); (p)[4] = (uint8_t) ((x) >> 24); \
+  (p)[5] = (uint8_t) ((x) >> 16); (p)[6] = (uint8_t) ((x) >>  8); \
+  (p)[7] = (uint8_t) (x); } while (0)
+
+// i-th byte of the rate-part of the state in big-endian order
+#define SBYTE(s, i) ((s)->b[(i) >> 3][7 ^ ((i) & 7)])
+
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` per 1000 bytes times 1000 for `n` bytes; the
+// result is a ULLInt since 1000000*t exceeds 32 bits on MSP430 after 4.29k
+// ticks, and it is 0 if no bytes were processed
+#define TICKSKB(t, n) ((n) ? (1000000*(ULLInt) (t))/(n) : 0ULL)
+
+
+// A job is an encryption or decryption of one message with ASCON128 or
+// ASCON128a. All buffers belong to the caller and must remain valid until
+// the job is returned by ascon_mb_submit or ascon_mb_flush. The output
+// buffer `out` can be the same as `in` (in-place processing).
+
+typedef struct {
+  const UChar *key;   // 16-byte key
+  const UChar *npub;  // 16-byte nonce
+  const UChar *ad;    // associated data
+  size_t adlen;
+  const UChar *in;    // plaintext (encryption) or ciphertext (decryption)
+  size_t inlen;
+  UChar *out;         // ciphertext or plaintext of length `inlen`
+  UChar *tag;         // 16-byte tag, written or verified
+  int variant;        // ASCON128 or ASCON128A
+  int decrypt;        // 0 for encryption, 1 for decryption
+  int status;         // MB_JOB_xxx, set by the manager
+  void *user;         // pointer for the caller, not used by the manager
+} MbJob;
+
+
+// A lane holds the job it is processing, the key-words, the positions in the
+// associated data and the message, the phase, and the rate and the number of
+// rounds of the intermediate permutation.
+
+typedef struct {
+  MbJob *job;
+  uint64_t k0, k1;
+  size_t adpos;
+  size_t inpos;
+  int phase;
+  int rate;
+  int nrb;
+} MbLane;
+
+
+// The manager keeps the states of all lanes in an array (as required by
+// ascon_multi) together with the number of rounds of the next permutation of
+// each lane. Completed jobs are buffered in a FIFO since a batch can complete
+// several jobs at once, but only one job is returned per call.
+
+typedef struct {
+  State s[MB_LANES];
+  int nr[MB_LANES];
+  MbLane lane[MB_LANES];
+  int busy;
+  MbJob *done[MB_LANES];
+  int dhead;
+  int dnum;
+} MbMgr;
+
+
+extern void ascon_c99_V3(State *s, int nr);
+extern void ascon_multi(State *s, const int *nr, int lanes);
+
+
+// Start of a job in lane `i`: the job is only registered here, the state is
+// loaded by mb_lane_pre in the first batch.
+
+static void mb_lane_start(MbMgr *mgr, int i, MbJob *job)
+{
+  MbLane *l = &mgr->lane[i];
+
+  l->job = job;
+  l->k0 = LOAD64(job->key);
+  l->k1 = LOAD64(job->key + 8);
+  l->adpos = l->inpos = 0;
+  l->phase = PHASE_INIT;
+  l->rate = (job->variant == ASCON128A) ? 16 : 8;
+  l->nrb = (job->variant == ASCON128A) ? 8 : 6;
+  job->status = MB_JOB_BUSY;
+  mgr->busy++;
+}
+
+
+// Processing of lane `i` before the permutation: the next block of the job
+// is absorbed (and the ciphertext or plaintext is extracted) and the number
+// of rounds of the permutation is set. A padded block ends the respective
+// phase; the last message block also gets the key addition of finalization.
+
+static void mb_lane_pre(MbMgr *mgr, int i)
+{
+  MbLane *l = &mgr->lane[i];
+  MbJob *job = l->job;
+  State *s = &mgr->s[i];
+  size_t len, k;
+  uint64_t w;
+  UChar cb;
+
+  switch (l->phase) {
+    case PHASE_INIT:
+      s->x[0] = (job->variant == ASCON128A) ? IV128A : IV128;
+      s->x[1] = l->k0;
+      s->x[2] = l->k1;
+      s->x[3] = LOAD64(job->npub);
+      s->x[4] = LOAD64(job->npub + 8);
+      mgr->nr[i] = 12;
+      break;
+    case PHASE_AD:
+      len = MIN(job->adlen - l->adpos, (size_t) l->rate);
+      for (k = 0; k < len; k++) SBYTE(s, k) ^= job->ad[l->adpos + k];
+      l->adpos += len;
+      if (len < (size_t) l->rate) {
+        SBYTE(s, len) ^= 0x80;
+        l->phase = PHASE_ADLAST;
+      }
+      mgr->nr[i] = l->nrb;
+      break;
+    default:  // PHASE_MSG
+      len = MIN(job->inlen - l->inpos, (size_t) l->rate);
+      // full blocks are processed word-wise, the last block byte-wise
+      for (k = 0; len == (size_t) l->rate && k < len; k += 8) {
+        w = LOAD64(job->in + l->inpos + k);
+        if (job->decrypt) {
+          STORE64(job->out + l->inpos + k, s->x[k >> 3] ^ w);
+          s->x[k >> 3] = w;
+        } else {
+          s->x[k >> 3] ^= w;
+          STORE64(job->out + l->inpos + k, s->x[k >> 3]);
+        }
+      }
+      for (k = 0; len < (size_t) l->rate && k < len; k++) {
+        cb = job->in[l->inpos + k];
+        if (job->decrypt) {
+          job->out[l->inpos + k] = SBYTE(s, k) ^ cb;
+          SBYTE(s, k) = cb;
+        } else {
+          SBYTE(s, k) ^= cb;
+          job->out[l->inpos + k] = SBYTE(s, k);
+        }
+      }
+      l->inpos += len;
+      mgr->nr[i] = l->nrb;
+      if (len < (size_t) l->rate) {
+        SBYTE(s, len) ^= 0x80;
+        s->x[l->rate >> 3] ^= l->k0;
+        s->x[(l->rate >> 3) + 1] ^= l->k1;
+        l->phase = PHASE_FINAL;
+        mgr->nr[i] = 12;
+      }
+      break;
+  }
+}
+
+
+// Processing of lane `i` after the permutation. Returns 1 if the job of the
+// lane is complete, i.e. the tag has been written or verified.
+
+static int mb_lane_post(MbMgr *mgr, int i)
+{
+  MbLane *l = &mgr->lane[i];
+  MbJob *job = l->job;
+  State *s = &mgr->s[i];
+  uint64_t diff;
+
+  switch (l->phase) {
+    case PHASE_INIT:
+      s->x[3] ^= l->k0;
+      s->x[4] ^= l->k1;
+      l->phase = PHASE_AD;
+      if (job->adlen > 0) break;
+      // no associated data: domain separation directly after initialization
+      s->x[4] ^= 1;
+      l->phase = PHASE_MSG;
+      break;
+    case PHASE_ADLAST:
+      s->x[4] ^= 1;
+      l->phase = PHASE_MSG;
+      break;
+    case PHASE_FINAL:
+      s->x[3] ^= l->k0;
+      s->x[4] ^= l->k1;
+      if (job->decrypt) {
+        diff = s->x[3] ^ LOAD64(job->tag);
+        diff |= s->x[4] ^ LOAD64(job->tag + 8);
+        diff |= diff >> 32;
+        diff |= diff >> 16;
+        diff |= diff >> 8;
+        job->status = ((diff & 0xff) == 0) ? MB_JOB_DONE : MB_JOB_FAIL;
+        if (job->status == MB_JOB_FAIL) memset(job->out, 0, job->inlen);
+      } else {
+        STORE64(job->tag, s->x[3]);
+        STORE64(job->tag + 8, s->x[4]);
+        job->status = MB_JOB_DONE;
+      }
+      return 1;
+    default:  // PHASE_AD and PHASE_MSG
+      break;
+  }
+
+  return 0;
+}
+
+
+// Execution of one batch: every busy lane processes its next block, all
+// states are permuted with a single call of ascon_multi (the idle lanes have
+// 0 rounds, i.e. their state is not changed), and the completed jobs are
+// moved from their lanes to the FIFO, which makes the lanes available again.
+
+static void mb_run(MbMgr *mgr)
+{
+  int i;
+
+  for (i = 0; i < MB_LANES; i++) {
+    if (mgr->lane[i].job != NULL) mb_lane_pre(mgr, i);
+    else mgr->nr[i] = 0;
+  }
+  ascon_multi(mgr->s, mgr->nr, MB_LANES);
+  for (i = 0; i < MB_LANES; i++) {
+    if ((mgr->lane[i].job != NULL) && mb_lane_post(mgr, i)) {
+      mgr->done[(mgr->dhead + mgr->dnum) % MB_LANES] = mgr->lane[i].job;
+      mgr->dnum++;
+      mgr->lane[i].job = NULL;
+      mgr->busy--;
+    }
+  }
+}
+
+
+// Removal of the oldest completed job from the FIFO (NULL if it is empty).
+
+static MbJob *mb_pop(MbMgr *mgr)
+{
+  MbJob *job;
+
+  if (mgr->dnum == 0) return NULL;
+  job = mgr->done[mgr->dhead];
+  mgr->dhead = (mgr->dhead + 1) % MB_LANES;
+  mgr->dnum--;
+
+  return job;
+}
+
+
+// Initialization of the job manager (all lanes are free).
+
+void ascon_mb_init(MbMgr *mgr)
+{
+  memset(mgr, 0, sizeof(MbMgr));
+}
+
+
+// Submission of a job. The job is put into a free lane; if all lanes are
+// busy afterwards, batches are executed until at least one job is complete.
+// The return value is a completed job (not necessarily the submitted one, and
+// not necessarily the first one submitted) or NULL if no job is complete yet.
+// There is always a free lane for the next submission.
+
+MbJob *ascon_mb_submit(MbMgr *mgr, MbJob *job)
+{
+  int i = 0;
+
+  while (mgr->lane[i].job != NULL) i++;
+  mb_lane_start(mgr, i, job);
+  if (mgr->busy == MB_LANES) {
+    while (mgr->dnum == 0) mb_run(mgr);
+  }
+
+  return mb_pop(mgr);
+}
+
+
+// Flushing of the manager when no further jobs are available. Batches with
+// partially filled lanes are executed until a job is complete, which is then
+// returned. The caller has to call this function until it returns NULL.
+
+MbJob *ascon_mb_flush(MbMgr *mgr)
+{
+  while ((mgr->dnum == 0) && (mgr->busy > 0)) mb_run(mgr);
+
+  return mb_pop(mgr);
+}
+
+
+// Print a byte-array in Hex format (the output is limited to the first 64
+// bytes of the byte-array).
+
+static void print_bytes(const char* str, const UChar *bytearray, size_t len)
+{
+  UChar buffer[148], byte;
+  size_t i, j, slen = 0;
+
+  if (str != NULL) {
+    slen = MIN(16, strlen(str));
+    memcpy(buffer, str, slen);
+  }
+
+  j = slen;
+  for (i = 0; i < MIN(64, len); i++) {
+    byte = bytearray[i] >> 4;
+    // replace 87 by 55 to get uppercase letters
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+    byte = bytearray[i] & 0xf;
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+  }
+  if (len > 64) {
+    buffer[j] = buffer[j+1] = buffer[j+2] = '.';
+    j += 3;
+  }
+  buffer[j] = '\0';
+
+  printf("%s\n", buffer);
+}
+
+
+extern void ascon_aead_encrypt(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant);
+
+
+// Simple test function for the job manager. Eleven jobs with message lengths
+// between 0 and 100 bytes (and 0 to 19 bytes of associated data) alternating
+// between ASCON128 and ASCON128a are encrypted, whereby the completion order
+// is printed; each result is compared with ascon_aead_encrypt. Then all
+// ciphertexts are decrypted in-place with the manager, where the tag of the
+// 4th job is tampered with, i.e. exactly this job has to fail.
+
+void ascon_test_mb(void)
+{
+  static const size_t mlen[11] = { 100, 0, 15, 16, 17, 1, 64, 8, 33, 7, 24 };
+  UChar key[16], npub[16], ad[20], msg[100], ct[11][100], tag[11][16];
+  UChar ref[100], rtag[16];
+  MbJob jobs[11], *job;
+  MbMgr mgr;
+  int i, j, errors = 0;
+
+  for (i = 0; i < 16; i++) key[i] = npub[i] = (UChar) i;
+  for (i = 0; i < 20; i++) ad[i] = (UChar) i;
+  for (i = 0; i < 100; i++) msg[i] = (UChar) i;
+
+  for (j = 0; j < 11; j++) {
+    jobs[j].key = key;
+    jobs[j].npub = npub;
+    jobs[j].ad = ad;
+    jobs[j].adlen = (j*7) % 20;
+    jobs[j].in = msg;
+    jobs[j].inlen = mlen[j];
+    jobs[j].out = ct[j];
+    jobs[j].tag = tag[j];
+    jobs[j].variant = j & 1;
+    jobs[j].decrypt = 0;
+    jobs[j].status = MB_JOB_NEW;
+  }
+
+  printf("Test 1 - Completion order of encryption jobs:\n");
+  ascon_mb_init(&mgr);
+  for (j = 0; j < 11; j++) {
+    if ((job = ascon_mb_submit(&mgr, &jobs[j])) != NULL) {
+      printf("%i ", (int) (job - jobs));
+    }
+  }
+  while ((job = ascon_mb_flush(&mgr)) != NULL) {
+    printf("%i ", (int) (job - jobs));
+  }
+  printf("\n");
+  print_bytes("C (job 0): ", ct[0], mlen[0]);
+  print_bytes("T (job 0): ", tag[0], 16);
+
+  for (j = 0; j < 11; j++) {
+    ascon_aead_encrypt(ref, rtag, msg, mlen[j], ad, jobs[j].adlen, npub, key,
+      jobs[j].variant);
+    errors += (memcmp(ref, ct[j], mlen[j]) != 0);
+    errors += (memcmp(rtag, tag[j], 16) != 0);
+    errors += (jobs[j].status != MB_JOB_DONE);
+  }
+  printf("Jobs differing from ascon_aead_encrypt: %i\n", errors);
+
+  printf("Test 2 - Decryption jobs (tag of job 3 is invalid):\n");
+  tag[3][15] ^= 1;
+  for (j = 0; j < 11; j++) {
+    jobs[j].in = jobs[j].out;
+    jobs[j].decrypt = 1;
+    ascon_mb_submit(&mgr, &jobs[j]);
+  }
+  while (ascon_mb_flush(&mgr) != NULL);
+  errors = 0;
+  for (j = 0; j < 11; j++) {
+    printf("%i ", jobs[j].status);
+    if (jobs[j].status == MB_JOB_DONE) {
+      errors += (memcmp(ct[j], msg, mlen[j]) != 0);
+    }
+  }
+  printf("\nPlaintexts differing from the original: %i\n", errors);
+
+  // Expected result for 4 lanes (the completion order with 8 lanes is
+  // 1 5 7 3 2 4 9 10 6 8 0, everything else is the same)
+  // ------------------------------------------------------------------
+  // Test 1 - Completion order of encryption jobs:
+  // 1 3 2 5 4 7 9 0 6 8 10
+  // C (job 0): bc820dbdf7a4631c5b29884ad69175c3389655ca8135c9e6e8fe7467276f89772e418b45a21ed0ea5c73801cd2feabd8f5f736d16c79aafcfafef0c62109fd8e...
+  // T (job 0): 2dc0a604cfc59a7249ec6ed7c89f9042
+  // Jobs differing from ascon_aead_encrypt: 0
+  // Test 2 - Decryption jobs (tag of job 3 is invalid):
+  // 2 2 2 3 2 2 2 2 2 2 2
+  // Plaintexts differing from the original: 0
+}
+
+
+// Sequential processing of a job in lane 0 of a manager with ascon_c99_V3,
+// i.e. one permutation call per block and no batching. This serves as the
+// reference for the benchmark below.
+
+static void mb_single(MbMgr *mgr, MbJob *job)
+{
+  mb_lane_start(mgr, 0, job);
+  do {
+    mb_lane_pre(mgr, 0);
+    ascon_c99_V3(&mgr->s[0], mgr->nr[0]);
+  } while (!mb_lane_post(mgr, 0));
+  mgr->lane[0].job = NULL;
+  mgr->busy--;
+}
+
+
+// Benchmark of the job manager with a mixed-length workload: `njobs`
+// ASCON128 encryption jobs with message lengths between 8 and 4096 bytes
+// (from a simple LCG, so the workload is the same for both runs) are
+// processed sequentially with ascon_c99_V3 and with the job manager. The
+// jobs are taken from a pool of MB_SLOTS job slots, which are recycled as
+// jobs are returned; the pool is larger than the number of jobs held by the
+// manager (in its lanes and its FIFO of completed jobs), so there is always
+// a free slot for the next submission. The printed values are the
+// number of CYCLES() ticks per 1000 bytes times 1000 and the checksum of the
+// first tag-byte of all jobs.
+
+#define MB_SLOTS (2*MB_LANES + 1)
+
+void ascon_bench_mb(long njobs)
+{
+  static UChar msg[4096], out[MB_SLOTS][4096];
+  UChar key[16], npub[16], tag[MB_SLOTS][16];
+  MbJob jobs[MB_SLOTS], *job, *pool[MB_SLOTS];
+  unsigned long start, stop, total, sum;
+  uint32_t lcg;
+  MbMgr mgr;
+  long n;
+  int i, nfree;
+
+  for (i = 0; i < 16; i++) key[i] = npub[i] = (UChar) i;
+  for (i = 0; i < 4096; i++) msg[i] = (UChar) i;
+  for (i = 0; i < MB_SLOTS; i++) {
+    jobs[i].key = key;
+    jobs[i].npub = npub;
+    jobs[i].ad = NULL;
+    jobs[i].adlen = 0;
+    jobs[i].in = msg;
+    jobs[i].out = out[i];
+    jobs[i].tag = tag[i];
+    jobs[i].variant = ASCON128;
+    jobs[i].decrypt = 0;
+  }
+
+  // sequential processing with ascon_c99_V3
+  ascon_mb_init(&mgr);
+  lcg = 1; total = sum = 0;
+  start = CYCLES();
+  for (n = 0; n < njobs; n++) {
+    lcg = 1664525*lcg + 1013904223;
+    jobs[0].inlen = 8 + (lcg >> 8) % 4089;
+    total += jobs[0].inlen;
+    mb_single(&mgr, &jobs[0]);
+    sum += tag[0][0];
+  }
+  stop = CYCLES();
+  printf("sequential (ascon_c99_V3): %llu (%08lx)\n",
+    TICKSKB(stop - start, total), sum);
+
+  // multi-buffer processing with ascon_multi
+  ascon_mb_init(&mgr);
+  for (i = 0; i < MB_SLOTS; i++) pool[i] = &jobs[i];
+  nfree = MB_SLOTS;
+  lcg = 1; total = sum = 0;
+  start = CYCLES();
+  for (n = 0; n < njobs; n++) {
+    lcg = 1664525*lcg + 1013904223;
+    job = pool[--nfree];
+    job->inlen = 8 + (lcg >> 8) % 4089;
+    total += job->inlen;
+    if ((job = ascon_mb_submit(&mgr, job)) != NULL) {
+      sum += job->tag[0];
+      pool[nfree++] = job;
+    }
+  }
+  while ((job = ascon_mb_flush(&mgr)) != NULL) {
+    sum += job->tag[0];
+    pool[nfree++] = job;
+  }
+  stop = CYCLES();
+  printf("multi-buffer (%i lanes)  : %llu (%08lx)\n", MB_LANES,
+    TICKSKB(stop - start, total), sum);
+}
@@ -0,0 +1,307 @@
+///////////////////////////////////////////////////////////////////////////////
+// ascon_multi.c: Multi-state implementation and unit-test of ASCON128 perm. //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if (defined(__AVX2__) || defined(__AVX512F__))
+#include <immintrin.h>
+#endif
+
+
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+typedef union {
+  uint64_t x[5];
+  uint32_t w[5][2];
+  uint8_t b[5][8];
+} State;
+
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// round constants
+#define START(n) (((n << 4) - n) + END)
+#define DEC 0x0f
+#define END 0x3c
+
+
+extern void ascon_c99(State *s, int nr);
+extern void ascon_c99_V3(State *s, int nr);
+
+
+// The scalar fallback permutes the states one after the other. Each lane `i`
+// gets its own number of rounds `nr[i]`, which allows to mix p^a and p^b
+// calls of different sessions in a single batch.
+
+void ascon_multi_c99(State *s, const int *nr, int lanes)
+{
+  int i;
+
+  for (i = 0; i < lanes; i++) ascon_c99_V3(&s[i], nr[i]);
+}
+
+
+#if defined(__AVX2__)
+
+// rotation macro for four 64-bit words
+#define ROR256(x, d) _mm256_or_si256(_mm256_srli_epi64((x), (d)), \
+  _mm256_slli_epi64((x), 64 - (d)))
+
+// store the lower and upper 128-bit half of a vector to two addresses
+#define STORE2X2(lo, hi, x) do { \
+  _mm_storeu_si128((__m128i *) (lo), _mm256_castsi256_si128(x)); \
+  _mm_storeu_si128((__m128i *) (hi), _mm256_extracti128_si256((x), 1)); \
+} while (0)
+
+// The macro `ROUND256` executes a round on five vectors containing the words
+// x[0]-x[4] of four states. It is the substitution layer and linear layer of
+// ascon_c99_V3, with the result of each operation assigned to `r0`-`r4`.
+
+#define ROUND256(r0, r1, r2, r3, r4, s0, s1, s2, s3, s4, rcv) do { \
+  __m256i ta, tb, tc, u0, u1, u2, u3, u4; \
+  u2 = _mm256_xor_si256(s2, rcv); \
+  ta = _mm256_xor_si256(s1, u2); \
+  tb = _mm256_xor_si256(s0, s4); \
+  tc = _mm256_xor_si256(s3, s4); \
+  u4 = _mm256_xor_si256(_mm256_or_si256(_mm256_xor_si256(s4, ones), s3), ta); \
+  u3 = _mm256_xor_si256(_mm256_or_si256(_mm256_xor_si256(s3, s1), ta), tb); \
+  u2 = _mm256_xor_si256(_mm256_or_si256(_mm256_xor_si256(u2, tb), s1), tc); \
+  u1 = _mm256_xor_si256(_mm256_andnot_si256(tb, s1), tc); \
+  u0 = _mm256_xor_si256(_mm256_or_si256(s0, tc), ta); \
+  r0 = _mm256_xor_si256(u2, _mm256_xor_si256(ROR256(u2, 19), ROR256(u2, 28))); \
+  r1 = _mm256_xor_si256(u3, _mm256_xor_si256(ROR256(u3, 61), ROR256(u3, 39))); \
+  r2 = _mm256_xor_si256(u4, _mm256_xor_si256(ROR256(u4,  1), ROR256(u4,  6))); \
+  r3 = _mm256_xor_si256(u0, _mm256_xor_si256(ROR256(u0, 10), ROR256(u0, 17))); \
+  r4 = _mm256_xor_si256(u1, _mm256_xor_si256(ROR256(u1,  7), ROR256(u1, 41))); \
+} while (0)
+
+
+// The 4-way AVX2 version permutes four independent states. All lanes share
+// the round-constant schedule; a lane with fewer rounds than the maximum
+// simply skips the first rounds (i.e. it keeps its old state until the round
+// constant reaches START(nr[i])), which yields the same result as ascon_c99.
+
+void ascon_x4_avx2(State *s, const int *nr)
+{
+  __m256i s0, s1, s2, s3, s4, r0, r1, r2, r3, r4, rcv, m;
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  __m256i start = _mm256_set_epi64x(START(nr[3]), START(nr[2]),
+    START(nr[1]), START(nr[0]));
+  int maxnr = MAX(MAX(nr[0], nr[1]), MAX(nr[2], nr[3]));
+  int minnr = MIN(MIN(nr[0], nr[1]), MIN(nr[2], nr[3]));
+  int rc;
+
+  // transposition of the four states into five vectors
+  s0 = _mm256_set_epi64x(s[3].x[0], s[2].x[0], s[1].x[0], s[0].x[0]);
+  s1 = _mm256_set_epi64x(s[3].x[1], s[2].x[1], s[1].x[1], s[0].x[1]);
+  s2 = _mm256_set_epi64x(s[3].x[2], s[2].x[2], s[1].x[2], s[0].x[2]);
+  s3 = _mm256_set_epi64x(s[3].x[3], s[2].x[3], s[1].x[3], s[0].x[3]);
+  s4 = _mm256_set_epi64x(s[3].x[4], s[2].x[4], s[1].x[4], s[0].x[4]);
+
+  // rounds in which only some of the lanes are active
+  for (rc = START(maxnr); rc > START(minnr); rc -= DEC) {
+    rcv = _mm256_set1_epi64x(rc);
+    m = _mm256_cmpgt_epi64(rcv, start);  // lanes that skip this round
+    ROUND256(r0, r1, r2, r3, r4, s0, s1, s2, s3, s4, rcv);
+    s0 = _mm256_blendv_epi8(r0, s0, m);
+    s1 = _mm256_blendv_epi8(r1, s1, m);
+    s2 = _mm256_blendv_epi8(r2, s2, m);
+    s3 = _mm256_blendv_epi8(r3, s3, m);
+    s4 = _mm256_blendv_epi8(r4, s4, m);
+  }
+  // rounds in which all lanes are active
+  for (; rc > END; rc -= DEC) {
+    rcv = _mm256_set1_epi64x(rc);
+    ROUND256(s0, s1, s2, s3, s4, s0, s1, s2, s3, s4, rcv);
+  }
+
+  // transposition back into the four states
+  STORE2X2(&s[0].x[0], &s[2].x[0], _mm256_unpacklo_epi64(s0, s1));
+  STORE2X2(&s[1].x[0], &s[3].x[0], _mm256_unpackhi_epi64(s0, s1));
+  STORE2X2(&s[0].x[2], &s[2].x[2], _mm256_unpacklo_epi64(s2, s3));
+  STORE2X2(&s[1].x[2], &s[3].x[2], _mm256_unpackhi_epi64(s2, s3));
+  s[0].x[4] = (uint64_t) _mm256_extract_epi64(s4, 0);
+  s[1].x[4] = (uint64_t) _mm256_extract_epi64(s4, 1);
+  s[2].x[4] = (uint64_t) _mm256_extract_epi64(s4, 2);
+  s[3].x[4] = (uint64_t) _mm256_extract_epi64(s4, 3);
+}
+
+#endif  // defined(__AVX2__)
+
+
+#if defined(__AVX512F__)
+
+// The macro `ROUND512` is the 8-way counterpart of `ROUND256`. The s-box is
+// computed with ternary-logic instructions (the 8-bit immediate is the truth
+// table of the respective Boolean function of the three inputs) and the
+// rotations with the native rotate instruction.
+
+#define ROUND512(r0, r1, r2, r3, r4, s0, s1, s2, s3, s4, rcv) do { \
+  __m512i ta, tb, tc, u0, u1, u2, u3, u4; \
+  u2 = _mm512_xor_si512(s2, rcv); \
+  ta = _mm512_xor_si512(s1, u2); \
+  tb = _mm512_xor_si512(s0, s4); \
+  tc = _mm512_xor_si512(s3, s4); \
+  u4 = _mm512_ternarylogic_epi64(s4, s3, ta, 0x65);  /* (~a | b) ^ c */ \
+  u3 = _mm512_ternarylogic_epi64(_mm512_xor_si512(s3, s1), ta, tb, 0x56); \
+  u2 = _mm512_ternarylogic_epi64(_mm512_xor_si512(u2, tb), s1, tc, 0x56); \
+  u1 = _mm512_ternarylogic_epi64(tb, s1, tc, 0xa6);  /* (~a & b) ^ c */ \
+  u0 = _mm512_ternarylogic_epi64(s0, tc, ta, 0x56);  /* (a | b) ^ c */ \
+  r0 = _mm512_ternarylogic_epi64(u2, _mm512_ror_epi64(u2, 19), \
+    _mm512_ror_epi64(u2, 28), 0x96); \
+  r1 = _mm512_ternarylogic_epi64(u3, _mm512_ror_epi64(u3, 61), \
+    _mm512_ror_epi64(u3, 39), 0x96); \
+  r2 = _mm512_ternarylogic_epi64(u4, _mm512_ror_epi64(u4,  1), \
+    _mm512_ror_epi64(u4,  6), 0x96); \
+  r3 = _mm512_ternarylogic_epi64(u0, _mm512_ror_epi64(u0, 10), \
+    _mm512_ror_epi64(u0, 17), 0x96); \
+  r4 = _mm512_ternarylogic_epi64(u1, _mm512_ror_epi64(u1,  7), \
+    _mm512_ror_epi64(u1, 41), 0x96); \
+} while (0)
+
+
+// The 8-way AVX-512 version permutes eight independent states, whereby the
+// lanes with fewer rounds are masked out of the first rounds.
+
+void ascon_x8_avx512(State *s, const int *nr)
+{
+  __m512i s0, s1, s2, s3, s4, r0, r1, r2, r3, r4, rcv, start;
+  const __m512i idx = _mm512_set_epi64(35, 30, 25, 20, 15, 10, 5, 0);
+  __mmask8 m;
+  int maxnr = nr[0], minnr = nr[0];
+  int rc, i;
+
+  for (i = 1; i < 8; i++) {
+    maxnr = MAX(maxnr, nr[i]);
+    minnr = MIN(minnr, nr[i]);
+  }
+  start = _mm512_set_epi64(START(nr[7]), START(nr[6]), START(nr[5]),
+    START(nr[4]), START(nr[3]), START(nr[2]), START(nr[1]), START(nr[0]));
+
+  // transposition of the eight states into five vectors (the states are
+  // contiguous in RAM, so the i-th word of the j-th state is at 5*j+i)
+  s0 = _mm512_i64gather_epi64(idx, &s[0].x[0], 8);
+  s1 = _mm512_i64gather_epi64(idx, &s[0].x[1], 8);
+  s2 = _mm512_i64gather_epi64(idx, &s[0].x[2], 8);
+  s3 = _mm512_i64gather_epi64(idx, &s[0].x[3], 8);
+  s4 = _mm512_i64gather_epi64(idx, &s[0].x[4], 8);
+
+  for (rc = START(maxnr); rc > START(minnr); rc -= DEC) {
+    rcv = _mm512_set1_epi64(rc);
+    m = _mm512_cmple_epi64_mask(rcv, start);  // lanes active in this round
+    ROUND512(r0, r1, r2, r3, r4, s0, s1, s2, s3, s4, rcv);
+    s0 = _mm512_mask_mov_epi64(s0, m, r0);
+    s1 = _mm512_mask_mov_epi64(s1, m, r1);
+    s2 = _mm512_mask_mov_epi64(s2, m, r2);
+    s3 = _mm512_mask_mov_epi64(s3, m, r3);
+    s4 = _mm512_mask_mov_epi64(s4, m, r4);
+  }
+  for (; rc > END; rc -= DEC) {
+    rcv = _mm512_set1_epi64(rc);
+    ROUND512(s0, s1, s2, s3, s4, s0, s1, s2, s3, s4, rcv);
+  }
+
+  _mm512_i64scatter_epi64(&s[0].x[0], idx, s0, 8);
+  _mm512_i64scatter_epi64(&s[0].x[1], idx, s1, 8);
+  _mm512_i64scatter_epi64(&s[0].x[2], idx, s2, 8);
+  _mm512_i64scatter_epi64(&s[0].x[3], idx, s3, 8);
+  _mm512_i64scatter_epi64(&s[0].x[4], idx, s4, 8);
+}
+
+#endif  // defined(__AVX512F__)
+
+
+// Batched permutation of an arbitrary number of states: groups of eight
+// states are processed with AVX-512, groups of four with AVX2, and the rest
+// with the scalar fallback (depending on which instruction sets are enabled
+// at compile time).
+
+void ascon_multi(State *s, const int *nr, int lanes)
+{
+  int i = 0;
+
+#if defined(__AVX512F__)
+  for (; i + 8 <= lanes; i += 8) ascon_x8_avx512(&s[i], &nr[i]);
+#endif
+#if defined(__AVX2__)
+  for (; i + 4 <= lanes; i += 4) ascon_x4_avx2(&s[i], &nr[i]);
+#endif
+  ascon_multi_c99(&s[i], &nr[i], lanes - i);
+}
+
+
+// Print the five state-words of ASCON128v12 in Hex format.
+
+static void print_state(State *s)
+{
+  UChar buffer[85], byte;
+  int i, j, k = 0;
+
+  for (i = 0; i < 5; i++) {
+    for (j = 15; j >= 0; j--) {
+      byte = (s->x[i] >> 4*j) & 0xf;
+      // replace 87 by 55 to get uppercase letters
+      buffer[k++] = byte + ((byte < 10) ? 48 : 87);
+    }
+    buffer[k++] = ' ';
+  }
+  buffer[k-1] = '\0';
+
+  printf("%s\n", buffer);
+}
+
+
+// Simple test function for the batched ASCON128v12 permutation. Eleven states
+// (i.e. one group of eight, a partial group of three) are initialized with
+// byte-indeces plus a lane-specific offset and permuted with 12, 8, 6, or 1
+// round(s). Every lane is compared with ascon_c99 and the first two lanes are
+// printed (lane 0 with 6 rounds matches Test 2 of ascon_test_perm).
+
+void ascon_test_multi(void)
+{
+  State s[11], t;
+  int nr[11] = { 6, 12, 8, 6, 1, 12, 12, 6, 8, 6, 12 };
+  int i, j, errors = 0;
+
+  for (j = 0; j < 11; j++) {
+    for (i = 0; i < 40; i++) s[j].b[i>>3][i&7] = (uint8_t) (i + 40*j);
+  }
+
+  printf("Test 1 - Multi-state implementation:\n");
+  ascon_multi(s, nr, 11);
+  print_state(&s[0]);
+  print_state(&s[1]);
+
+  for (j = 0; j < 11; j++) {
+    for (i = 0; i < 40; i++) t.b[i>>3][i&7] = (uint8_t) (i + 40*j);
+    ascon_c99(&t, nr[j]);
+    errors += (memcmp(&t, &s[j], sizeof(State)) != 0);
+  }
+  printf("Lanes differing from ascon_c99: %i\n", errors);
+
+  // Expected result
+  // ---------------
+  // Test 1 - Multi-state implementation:
+  // eabb307b20741574 69f9b6e6f3c87f1c 3ed22b3cefcfe13d ac5b1fd401664b92 e62f2ef2099605d0
+  // 97d4c887a69710b9 5640985b01571261 c533da295e77ab54 3602e6c8c951d03e a1992eedfa53f959
+  // Lanes differing from ascon_c99: 0
+}
@@ -26,22 +26,47 @@ typedef unsigned long long int ULLInt;
 typedef union {
   uint64_t x[5];
   uint32_t w[5][2];
+  uint16_t h[5][4];
   uint8_t b[5][8];
 } State;
 
 
-// rotation macro
+// rotation macros
 #define ROR64(x, d) (((x) >> (d)) | ((x) << (64 - (d))))
+#define ROR32(x, d) (((x) >> ((d) & 31)) | ((x) << ((32 - (d)) & 31)))
+#define ROR16(x, d) ((uint16_t) (((x) >> ((d) & 15)) | ((x) << ((16 - (d)) & 15))))
 
 // min/max macros
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
 
+// load/store of a big-endian 64-bit word from/to an unaligned byte-array
+#define LOAD64(p) (((uint64_t) (p)[0] << 56) | ((uint64_t) (p)[1] << 48) | \
+  ((uint64_t) (p)[2] << 40) | ((uint64_t) (p)[3] << 32) | \
+  ((uint64_t) (p)[4] << 24) | ((uint64_t) (p)[5] << 16) | \
+  ((uint64_t) (p)[6] <<  8) | ((uint64_t) (p)[7]))
+#define STORE64(p, x) do { (p)[0] = (uint8_t) ((x) >> 56); \
+  (p)[1] = (uint8_t) ((x) >> 48); (p)[2] = (uint8_t) ((x) >> 40); \
+  (p)[3] = (uint8_t) ((x) >> 32); (p)[4] = (uint8_t) ((x) >> 24); \
+  (p)[5] = (uint8_t) ((x) >> 16); (p)[6] = (uint8_t) ((x) >>  8); \
+  (p)[7] = (uint8_t) (x); } while (0)
+
 // round constants
 #define START(n) (((n << 4) - n) + END)
 #define DEC 0x0f
 #define END 0x3c
 
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` times 1000 divided by `n`; the result is a
+// ULLInt since 1000*t exceeds 32 bits on MSP430 after 4.29M ticks
+#define TICKS1000(t, n) ((1000*(ULLInt) (t))/(n))
+
 
 #if (defined(__AVR) || defined(__AVR__))
 extern void ascon_avr(State *s, int nr);
@@ -51,7 +76,29 @@ extern void ascon_avr(State *s, int nr);
 
 #if (defined(__MSP430__) || defined(__ICC430__))
 extern void ascon_msp(State *s, int nr);
+extern void ascon_msp_p12(State *s);
+extern void ascon_msp_p8(State *s);
+extern void ascon_msp_p6(State *s);
+extern void ascon_msp_p1(State *s);
+extern void ascon_msp_p12k(State *s, const uint64_t *kpre,
+  const uint64_t *kpost);
 #define ascon_asm(s, nr) ascon_msp((s), (nr))
+#define ascon_asm_p12(s) ascon_msp_p12((s))
+#define ascon_asm_p8(s) ascon_msp_p8((s))
+#define ascon_asm_p6(s) ascon_msp_p6((s))
+#define ascon_asm_p1(s) ascon_msp_p1((s))
+extern void ascon_msp_absorb(State *s, int nr, const UChar *in, int nw);
+extern void ascon_msp_encrypt(State *s, int nr, const UChar *in, int nw,
+  UChar *out);
+extern void ascon_msp_decrypt(State *s, int nr, const UChar *in, int nw,
+  UChar *out);
+#define ascon_asm_p12k(s, kpre, kpost) ascon_msp_p12k((s), (kpre), (kpost))
+#define ascon_asm_absorb(s, nr, in, nw) \
+  ascon_msp_absorb((s), (nr), (in), (nw))
+#define ascon_asm_encrypt(s, nr, in, nw, out) \
+  ascon_msp_encrypt((s), (nr), (in), (nw), (out))
+#define ascon_asm_decrypt(s, nr, in, nw, out) \
+  ascon_msp_decrypt((s), (nr), (in), (nw), (out))
 #define ASCON_ASSEMBLER
 #endif
 
@@ -180,6 +227,386 @@ void ascon_c99_V3(State *s, int nr)
 }
 
 
+// Round constants in bit-interleaved form for the 32-bit version (the even
+// bits are in the lower nibble, the odd bits in the upper nibble); the index
+// is the lower nibble of the ordinary round constant.
+
+static const uint8_t rcbi32[12] = {
+  0xcc, 0xc9, 0x9c, 0x99, 0xc6, 0xc3, 0x96, 0x93, 0x6c, 0x69, 0x3c, 0x39
+};
+
+
+// The macro `SBOX` is the substitution layer of ascon_c99_V3 on a single
+// slice of 8, 16, 32, or 64 bits. After the s-box, `s2` contains the slice of
+// x[0], `s3` of x[1], `s4` of x[2], `s0` of x[3], and `s1` of x[4].
+
+#define SBOX(s0, s1, s2, s3, s4, ta, tb, tc) do { \
+  ta = s1 ^ s2; tb = s0 ^ s4; tc = s3 ^ s4;       \
+  s4 = (~s4 | s3) ^ ta;                           \
+  s3 = ((s3 ^ s1) | ta) ^ tb;                     \
+  s2 = ((s2 ^ tb) | s1) ^ tc;                     \
+  s1 = (s1 & ~tb) ^ tc;                           \
+  s0 = (s0 | tc) ^ ta;                            \
+} while (0)
+
+// The macros `BIROR32` and `BIROR16` rotate a bit-interleaved 64-bit word
+// `x` by `d` bits and yield slice `k` of the result. For 32-bit slices, a
+// rotation by an even amount rotates both slices by d/2 bits, whereas an odd
+// amount swaps the slices in addition (analogously for 16-bit slices).
+
+#define BIROR32(x, k, d) \
+  ROR32(x[((k) + (d)) & 1], ((d) >> 1) + (((k) + ((d) & 1)) >> 1))
+#define BIROR16(x, k, d) \
+  ROR16(x[((k) + (d)) & 3], ((d) >> 2) + (((k) + ((d) & 3)) >> 2))
+
+// The macros `LINBI32` and `LINBI16` compute x ^ (x >>> a) ^ (x >>> b) for a
+// bit-interleaved word `x` and write the slices of the result to `y`.
+
+#define LINBI32(y, x, a, b) do { \
+  y[0] = x[0] ^ BIROR32(x, 0, a) ^ BIROR32(x, 0, b); \
+  y[1] = x[1] ^ BIROR32(x, 1, a) ^ BIROR32(x, 1, b); \
+} while (0)
+
+#define LINBI16(y, x, a, b) do { \
+  y[0] = x[0] ^ BIROR16(x, 0, a) ^ BIROR16(x, 0, b); \
+  y[1] = x[1] ^ BIROR16(x, 1, a) ^ BIROR16(x, 1, b); \
+  y[2] = x[2] ^ BIROR16(x, 2, a) ^ BIROR16(x, 2, b); \
+  y[3] = x[3] ^ BIROR16(x, 3, a) ^ BIROR16(x, 3, b); \
+} while (0)
+
+
+// The 4th version of the ASCON128v12 permutation operates on a bit-interleaved
+// state in which each 64-bit word is split up into a 32-bit slice with the
+// even bits (w[i][0]) and a 32-bit slice with the odd bits (w[i][1]), so all
+// rotations become 32-bit rotations. The state has to be converted with
+// ascon_to_bi32 before and ascon_from_bi32 after a sequence of permutations.
+
+void ascon_c99_V4(State *s, int nr)
+{
+  uint32_t x0[2], x1[2], x2[2], x3[2], x4[2], y[5][2];
+  uint32_t ta, tb, tc;
+  int rc, k;
+
+  for (k = 0; k < 2; k++) {
+    x0[k] = s->w[0][k]; x1[k] = s->w[1][k]; x2[k] = s->w[2][k];
+    x3[k] = s->w[3][k]; x4[k] = s->w[4][k];
+  }
+
+  for (rc = START(nr); rc > END; rc -= DEC) {
+    // addition of round constant
+    x2[0] ^= rcbi32[rc & 15] & 15;
+    x2[1] ^= rcbi32[rc & 15] >> 4;
+    // substitution layer
+    SBOX(x0[0], x1[0], x2[0], x3[0], x4[0], ta, tb, tc);
+    SBOX(x0[1], x1[1], x2[1], x3[1], x4[1], ta, tb, tc);
+    // linear diffusion layer
+    LINBI32(y[0], x2, 19, 28);
+    LINBI32(y[1], x3, 61, 39);
+    LINBI32(y[2], x4,  1,  6);
+    LINBI32(y[3], x0, 10, 17);
+    LINBI32(y[4], x1,  7, 41);
+    for (k = 0; k < 2; k++) {
+      x0[k] = y[0][k]; x1[k] = y[1][k]; x2[k] = y[2][k];
+      x3[k] = y[3][k]; x4[k] = y[4][k];
+    }
+  }
+
+  for (k = 0; k < 2; k++) {
+    s->w[0][k] = x0[k]; s->w[1][k] = x1[k]; s->w[2][k] = x2[k];
+    s->w[3][k] = x3[k]; s->w[4][k] = x4[k];
+  }
+}
+
+
+// The 5th version of the ASCON128v12 permutation is the 16-bit counterpart of
+// the 4th version: each 64-bit word is split up into four 16-bit slices such
+// that h[i][k] contains the bits with an index of k mod 4. The round constant
+// of round r has in slice k the value 1 if bit k of r is set and 2 otherwise.
+
+void ascon_c99_V5(State *s, int nr)
+{
+  uint16_t x0[4], x1[4], x2[4], x3[4], x4[4], y[5][4];
+  uint16_t ta, tb, tc;
+  int rc, k;
+
+  for (k = 0; k < 4; k++) {
+    x0[k] = s->h[0][k]; x1[k] = s->h[1][k]; x2[k] = s->h[2][k];
+    x3[k] = s->h[3][k]; x4[k] = s->h[4][k];
+  }
+
+  for (rc = START(nr); rc > END; rc -= DEC) {
+    // addition of round constant
+    x2[0] ^= 2 >> (rc & 1);
+    x2[1] ^= 2 >> ((rc >> 1) & 1);
+    x2[2] ^= 2 >> ((rc >> 2) & 1);
+    x2[3] ^= 2 >> ((rc >> 3) & 1);
+    // substitution layer
+    SBOX(x0[0], x1[0], x2[0], x3[0], x4[0], ta, tb, tc);
+    SBOX(x0[1], x1[1], x2[1], x3[1], x4[1], ta, tb, tc);
+    SBOX(x0[2], x1[2], x2[2], x3[2], x4[2], ta, tb, tc);
+    SBOX(x0[3], x1[3], x2[3], x3[3], x4[3], ta, tb, tc);
+    // linear diffusion layer
+    LINBI16(y[0], x2, 19, 28);
+    LINBI16(y[1], x3, 61, 39);
+    LINBI16(y[2], x4,  1,  6);
+    LINBI16(y[3], x0, 10, 17);
+    LINBI16(y[4], x1,  7, 41);
+    for (k = 0; k < 4; k++) {
+      x0[k] = y[0][k]; x1[k] = y[1][k]; x2[k] = y[2][k];
+      x3[k] = y[3][k]; x4[k] = y[4][k];
+    }
+  }
+
+  for (k = 0; k < 4; k++) {
+    s->h[0][k] = x0[k]; s->h[1][k] = x1[k]; s->h[2][k] = x2[k];
+    s->h[3][k] = x3[k]; s->h[4][k] = x4[k];
+  }
+}
+
+
+// The macro `DELTASWAP` exchanges the bits of `x` selected by `m` with the
+// bits `d` positions to the left of them.
+
+#define DELTASWAP(x, m, d) do {              \
+  uint64_t t_ = ((x) ^ ((x) >> (d))) & (m);  \
+  (x) ^= t_ ^ (t_ << (d));                   \
+} while (0)
+
+// Moves in both 32-bit halves of a word the even bits to the lower 16 bits
+// and the odd bits to the upper 16 bits (`UNZIP`), and back (`ZIP`).
+
+#define UNZIP(x) do {                            \
+  DELTASWAP(x, 0x2222222222222222ULL, 1);        \
+  DELTASWAP(x, 0x0C0C0C0C0C0C0C0CULL, 2);        \
+  DELTASWAP(x, 0x00F000F000F000F0ULL, 4);        \
+  DELTASWAP(x, 0x0000FF000000FF00ULL, 8);        \
+} while (0)
+
+#define ZIP(x) do {                              \
+  DELTASWAP(x, 0x0000FF000000FF00ULL, 8);        \
+  DELTASWAP(x, 0x00F000F000F000F0ULL, 4);        \
+  DELTASWAP(x, 0x0C0C0C0C0C0C0C0CULL, 2);        \
+  DELTASWAP(x, 0x2222222222222222ULL, 1);        \
+} while (0)
+
+// exchange of the two middle 16-bit parts of a 64-bit word
+#define SWAP16(x) DELTASWAP(x, 0x00000000FFFF0000ULL, 16)
+
+
+// Conversion of a 64-bit word into bit-interleaved form with 32-bit slices
+// (even bits in the lower half, odd bits in the upper half) and back. A mode
+// of operation has to convert only the words it absorbs or squeezes, i.e. it
+// XORs ascon_to_bi32(m) into the rate and extracts ascon_from_bi32(x[0]).
+
+uint64_t ascon_to_bi32(uint64_t x)
+{
+  UNZIP(x);
+  SWAP16(x);
+
+  return x;
+}
+
+
+uint64_t ascon_from_bi32(uint64_t x)
+{
+  SWAP16(x);
+  ZIP(x);
+
+  return x;
+}
+
+
+// Conversion of a 64-bit word into bit-interleaved form with 16-bit slices
+// (the k-th slice contains the bits with index k mod 4) and back.
+
+uint64_t ascon_to_bi16(uint64_t x)
+{
+  UNZIP(x);
+  SWAP16(x);
+  UNZIP(x);
+  SWAP16(x);
+
+  return x;
+}
+
+
+uint64_t ascon_from_bi16(uint64_t x)
+{
+  SWAP16(x);
+  ZIP(x);
+  SWAP16(x);
+  ZIP(x);
+
+  return x;
+}
+
+// The macro `ROUND` executes a round of the 3rd version of the permutation on
+// the local variables s0-s4 with a round-constant `rc` that is known at
+// compile time. The macros `ROUNDS_Px` are the unrolled sequences of rounds
+// of the permutations p12, p8, p6, and p1; they follow the START/DEC/END
+// schedule, i.e. the 1st round of px uses the round-constant START(x).
+
+#define ROUND(rc) do { \
+  s2 ^= (uint64_t) (rc); \
+  SBOX(s0, s1, s2, s3, s4, ta, tb, tc); \
+  r0 = s2; r1 = s3; r2 = s4; r3 = s0; r4 = s1; \
+  s0 = r0 ^ ROR64(r0, 19) ^ ROR64(r0, 28); \
+  s1 = r1 ^ ROR64(r1, 61) ^ ROR64(r1, 39); \
+  s2 = r2 ^ ROR64(r2,  1) ^ ROR64(r2,  6); \
+  s3 = r3 ^ ROR64(r3, 10) ^ ROR64(r3, 17); \
+  s4 = r4 ^ ROR64(r4,  7) ^ ROR64(r4, 41); \
+} while (0)
+
+#define ROUNDS_P1 ROUND(START(1))
+#define ROUNDS_P6 ROUND(START(6)); ROUND(START(5)); ROUND(START(4)); \
+  ROUND(START(3)); ROUND(START(2)); ROUNDS_P1
+#define ROUNDS_P8 ROUND(START(8)); ROUND(START(7)); ROUNDS_P6
+#define ROUNDS_P12 ROUND(START(12)); ROUND(START(11)); ROUND(START(10)); \
+  ROUND(START(9)); ROUNDS_P8
+
+// The macro `PERMFUNC` generates a fully unrolled permutation function with a
+// fixed number of rounds.
+
+#define PERMFUNC(name, rounds) \
+void name(State *s) \
+{ \
+  uint64_t s0 = s->x[0], s1 = s->x[1], s2 = s->x[2]; \
+  uint64_t s3 = s->x[3], s4 = s->x[4]; \
+  uint64_t ta, tb, tc; \
+  uint64_t r0, r1, r2, r3, r4; \
+  rounds; \
+  s->x[0] = s0; \
+  s->x[1] = s1; \
+  s->x[2] = s2; \
+  s->x[3] = s3; \
+  s->x[4] = s4; \
+}
+
+
+// Specializations of the 3rd version of the ASCON128v12 permutation for 12, 8,
+// 6, and 1 round(s). They are fully unrolled, i.e. there is no loop overhead
+// and all round-constants are immediate operands.
+
+PERMFUNC(ascon_c99_p12, ROUNDS_P12)
+PERMFUNC(ascon_c99_p8, ROUNDS_P8)
+PERMFUNC(ascon_c99_p6, ROUNDS_P6)
+PERMFUNC(ascon_c99_p1, ROUNDS_P1)
+
+
+// Permutation with a number of rounds that is only known at run-time. The
+// four common cases are dispatched to the unrolled specializations, all other
+// cases to ascon_c99_V3 as fallback.
+
+void ascon_c99_pn(State *s, int nr)
+{
+  switch (nr) {
+    case 12: ascon_c99_p12(s); break;
+    case 8: ascon_c99_p8(s); break;
+    case 6: ascon_c99_p6(s); break;
+    case 1: ascon_c99_p1(s); break;
+    default: ascon_c99_V3(s, nr); break;
+  }
+}
+
+
+// 12-round permutation with fused key additions for the initialization and
+// finalization of the AEAD modes. The three words of `kpre` are XORed to the
+// state-words x[1]-x[3] before the first round and the three words of `kpost`
+// to x[2]-x[4] after the last round, while the state is held in registers
+// (either pointer can be NULL). This covers the key additions of ASCON128,
+// ASCON128a, and ASCON80pq, where the latter has a 160-bit key.
+
+void ascon_c99_p12k(State *s, const uint64_t *kpre, const uint64_t *kpost)
+{
+  uint64_t s0 = s->x[0], s1 = s->x[1], s2 = s->x[2];
+  uint64_t s3 = s->x[3], s4 = s->x[4];
+  uint64_t ta, tb, tc;
+  uint64_t r0, r1, r2, r3, r4;
+
+  if (kpre != NULL) {
+    s1 ^= kpre[0];
+    s2 ^= kpre[1];
+    s3 ^= kpre[2];
+  }
+  ROUNDS_P12;
+  if (kpost != NULL) {
+    s2 ^= kpost[0];
+    s3 ^= kpost[1];
+    s4 ^= kpost[2];
+  }
+  s->x[0] = s0;
+  s->x[1] = s1;
+  s->x[2] = s2;
+  s->x[3] = s3;
+  s->x[4] = s4;
+}
+
+
+// The macro `ROUNDS_PN` executes `nr` rounds on the local variables s0-s4; the
+// common round-counts use the unrolled sequences, all others a round-loop.
+
+#define ROUNDS_PN(nr) do { \
+  switch (nr) { \
+    case 12: ROUNDS_P12; break; \
+    case 8: ROUNDS_P8; break; \
+    case 6: ROUNDS_P6; break; \
+    default: for (rc = START(nr); rc > END; rc -= DEC) ROUND(rc); break; \
+  } \
+} while (0)
+
+// The macros `ABSWORD`, `ENCWORD`, and `DECWORD` process the i-th big-endian
+// 64-bit word of the input with state-word x: x ^= in (absorb), x ^= in and
+// out = x (encrypt), out = x ^ in and x = in (decrypt). The input is loaded
+// before the output is stored, i.e. `out` can be the same buffer as `in`.
+
+#define ABSWORD(x, i) do { (x) ^= LOAD64(in + 8*(i)); } while (0)
+#define ENCWORD(x, i) do { \
+  (x) ^= LOAD64(in + 8*(i)); STORE64(out + 8*(i), (x)); } while (0)
+#define DECWORD(x, i) do { \
+  ta = LOAD64(in + 8*(i)); (x) ^= ta; STORE64(out + 8*(i), (x)); (x) = ta; \
+} while (0)
+
+// The macro `FUSEDFUNC` generates a fused absorb-and-permute function, which
+// processes `nw` (1 <= nw <= 4) rate-words with the macro `word` and executes
+// the permutation while the state is held in local variables.
+
+#define FUSEDFUNC(name, params, word) \
+void name params \
+{ \
+  uint64_t s0 = s->x[0], s1 = s->x[1], s2 = s->x[2]; \
+  uint64_t s3 = s->x[3], s4 = s->x[4]; \
+  uint64_t ta, tb, tc; \
+  uint64_t r0, r1, r2, r3, r4; \
+  int rc; \
+  word(s0, 0); \
+  if (nw > 1) word(s1, 1); \
+  if (nw > 2) word(s2, 2); \
+  if (nw > 3) word(s3, 3); \
+  ROUNDS_PN(nr); \
+  s->x[0] = s0; \
+  s->x[1] = s1; \
+  s->x[2] = s2; \
+  s->x[3] = s3; \
+  s->x[4] = s4; \
+}
+
+
+// Fused absorb-and-permute kernels for the modes of operation. They combine
+// the `nw` big-endian words of `in` with the rate-words x[0], x[1], ... of
+// the state, write the ciphertext (encrypt) or plaintext (decrypt) to `out`,
+// and execute the `nr`-round permutation in a single pass, i.e. the state is
+// loaded and stored only once per block. The parameter order is the same as
+// that of the Assembler versions (ascon_msp_absorb etc.), where the number of
+// rounds stays in the register it is passed in.
+
+FUSEDFUNC(ascon_c99_absorb, (State *s, int nr, const UChar *in, int nw),
+  ABSWORD)
+FUSEDFUNC(ascon_c99_encrypt, (State *s, int nr, const UChar *in, int nw,
+  UChar *out), ENCWORD)
+FUSEDFUNC(ascon_c99_decrypt, (State *s, int nr, const UChar *in, int nw,
+  UChar *out), DECWORD)
+
+
 // Print the five state-words of ASCON128v12 in Hex format.
 
 static void print_state(State *s)
@@ -291,3 +718,211 @@ void ascon_test_perm(int rounds)
   // 0706050403020100 0f0e0d0c0b0a0908 1716151413121110 1f1e1d1c1b1a1918 2726252423222120
   // eabb307b20741574 69f9b6e6f3c87f1c 3ed22b3cefcfe13d ac5b1fd401664b92 e62f2ef2099605d0
 }
+
+
+// Simple test function for the bit-interleaved versions of the ASCON128v12
+// permutation. The state is initialized with byte-indeces like in the 2nd
+// test above, converted to bit-interleaved form, permuted, and converted
+// back, i.e. the output must be the same as that of the 2nd test above.
+
+void ascon_test_perm_bi(int rounds)
+{
+  State s;
+  int i;
+
+  printf("Test 2 - C99 implementation (BI32):\n");
+  for (i = 0; i < 40; i++) ((uint8_t *) &s)[i] = (uint8_t) i;
+  print_state(&s);
+  for (i = 0; i < 5; i++) s.x[i] = ascon_to_bi32(s.x[i]);
+  ascon_c99_V4(&s, rounds);  // permutation in C
+  for (i = 0; i < 5; i++) s.x[i] = ascon_from_bi32(s.x[i]);
+  print_state(&s);
+
+  printf("Test 2 - C99 implementation (BI16):\n");
+  for (i = 0; i < 40; i++) ((uint8_t *) &s)[i] = (uint8_t) i;
+  print_state(&s);
+  for (i = 0; i < 5; i++) s.x[i] = ascon_to_bi16(s.x[i]);
+  ascon_c99_V5(&s, rounds);  // permutation in C
+  for (i = 0; i < 5; i++) s.x[i] = ascon_from_bi16(s.x[i]);
+  print_state(&s);
+
+  // Expected result for 6 rounds
+  // ----------------------------
+  // Test 2 - C99 implementation (BI32):
+  // 0706050403020100 0f0e0d0c0b0a0908 1716151413121110 1f1e1d1c1b1a1918 2726252423222120
+  // eabb307b20741574 69f9b6e6f3c87f1c 3ed22b3cefcfe13d ac5b1fd401664b92 e62f2ef2099605d0
+  // Test 2 - C99 implementation (BI16):
+  // 0706050403020100 0f0e0d0c0b0a0908 1716151413121110 1f1e1d1c1b1a1918 2726252423222120
+  // eabb307b20741574 69f9b6e6f3c87f1c 3ed22b3cefcfe13d ac5b1fd401664b92 e62f2ef2099605d0
+}
+
+
+// Benchmark of the permutation versions on the same input. Each version is
+// executed `iter` times on the state of the 2nd test; the bit-interleaved
+// versions are timed without the conversion since a mode of operation keeps
+// the state in bit-interleaved form and converts only the rate-words. The
+// printed value is the number of CYCLES() ticks per permutation call times
+// 1000, followed by the checksum of the final state (which is identical for
+// all versions after the conversion back to normal form).
+
+void ascon_bench_perm(int rounds, long iter)
+{
+  State s;
+  unsigned long start, stop;
+  long n;
+  int i;
+
+  for (i = 0; i < 40; i++) ((uint8_t *) &s)[i] = (uint8_t) i;
+  start = CYCLES();
+  for (n = 0; n < iter; n++) ascon_c99_V3(&s, rounds);
+  stop = CYCLES();
+  printf("ascon_c99_V3: %llu (%08lx)\n", TICKS1000(stop - start, iter),
+    (unsigned long) (s.w[0][0] ^ s.w[4][1]));
+
+#if defined(ASCON_ASSEMBLER)
+  for (i = 0; i < 40; i++) ((uint8_t *) &s)[i] = (uint8_t) i;
+  start = CYCLES();
+  for (n = 0; n < iter; n++) ascon_asm(&s, rounds);
+  stop = CYCLES();
+  printf("ascon_asm   : %llu (%08lx)\n", TICKS1000(stop - start, iter),
+    (unsigned long) (s.w[0][0] ^ s.w[4][1]));
+#endif
+
+  for (i = 0; i < 40; i++) ((uint8_t *) &s)[i] = (uint8_t) i;
+  for (i = 0; i < 5; i++) s.x[i] = ascon_to_bi32(s.x[i]);
+  start = CYCLES();
+  for (n = 0; n < iter; n++) ascon_c99_V4(&s, rounds);
+  stop = CYCLES();
+  for (i = 0; i < 5; i++) s.x[i] = ascon_from_bi32(s.x[i]);
+  printf("ascon_c99_V4: %llu (%08lx)\n", TICKS1000(stop - start, iter),
+    (unsigned long) (s.w[0][0] ^ s.w[4][1]));
+
+  for (i = 0; i < 40; i++) ((uint8_t *) &s)[i] = (uint8_t) i;
+  for (i = 0; i < 5; i++) s.x[i] = ascon_to_bi16(s.x[i]);
+  start = CYCLES();
+  for (n = 0; n < iter; n++) ascon_c99_V5(&s, rounds);
+  stop = CYCLES();
+  for (i = 0; i < 5; i++) s.x[i] = ascon_from_bi16(s.x[i]);
+  printf("ascon_c99_V5: %llu (%08lx)\n", TICKS1000(stop - start, iter),
+    (unsigned long) (s.w[0][0] ^ s.w[4][1]));
+}
+
+
+// Benchmark of the unrolled specializations. Each of p12, p8, p6, and p1 is
+// executed `iter` times with ascon_c99_V3 (round-count at run-time) and with
+// the respective specialization (and the same for the Assembler versions).
+// The printed value is the number of CYCLES() ticks per call times 1000.
+
+void ascon_bench_rounds(long iter)
+{
+  static const int rounds[4] = { 12, 8, 6, 1 };
+  unsigned long start, t_v3, t_px;
+  State s;
+  long n;
+  int i, r;
+
+  for (r = 0; r < 4; r++) {
+    for (i = 0; i < 40; i++) ((uint8_t *) &s)[i] = (uint8_t) i;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) ascon_c99_V3(&s, rounds[r]);
+    t_v3 = CYCLES() - start;
+    start = CYCLES();
+    switch (rounds[r]) {
+      case 12: for (n = 0; n < iter; n++) ascon_c99_p12(&s); break;
+      case 8: for (n = 0; n < iter; n++) ascon_c99_p8(&s); break;
+      case 6: for (n = 0; n < iter; n++) ascon_c99_p6(&s); break;
+      default: for (n = 0; n < iter; n++) ascon_c99_p1(&s); break;
+    }
+    t_px = CYCLES() - start;
+    printf("p%-2i: ascon_c99_V3 %llu, ascon_c99_p%i %llu\n", rounds[r],
+      TICKS1000(t_v3, iter), rounds[r], TICKS1000(t_px, iter));
+
+#if defined(ascon_asm_p12)
+    start = CYCLES();
+    for (n = 0; n < iter; n++) ascon_asm(&s, rounds[r]);
+    t_v3 = CYCLES() - start;
+    start = CYCLES();
+    switch (rounds[r]) {
+      case 12: for (n = 0; n < iter; n++) ascon_asm_p12(&s); break;
+      case 8: for (n = 0; n < iter; n++) ascon_asm_p8(&s); break;
+      case 6: for (n = 0; n < iter; n++) ascon_asm_p6(&s); break;
+      default: for (n = 0; n < iter; n++) ascon_asm_p1(&s); break;
+    }
+    t_px = CYCLES() - start;
+    printf("p%-2i: ascon_asm %llu, ascon_asm_p%i %llu\n", rounds[r],
+      TICKS1000(t_v3, iter), rounds[r], TICKS1000(t_px, iter));
+#endif
+  }
+}
+
+
+// Benchmark of the fused absorb-and-permute kernels. A 128-byte message is
+// encrypted in-place block by block with the rate and round-count of
+// ASCON128 (8 bytes, p6) and ASCON128a (16 bytes, p8), once with the three
+// separate passes (conversion of the rate-words in C, permutation, and
+// conversion of the ciphertext in C) and once with the fused kernel. The
+// printed value is the number of CYCLES() ticks per block times 1000,
+// followed by the checksum of the final state and ciphertext (which has to
+// be identical for all versions).
+
+void ascon_bench_fused(long iter)
+{
+  static const int rounds[2] = { 6, 8 };
+  UChar buf[128];
+  unsigned long start, stop;
+  State s;
+  long n;
+  int i, j, r, nw;
+
+  for (r = 0; r < 2; r++) {
+    nw = (rounds[r] == 8) ? 2 : 1;
+    for (i = 0; i < 40; i++) ((uint8_t *) &s)[i] = (uint8_t) i;
+    for (i = 0; i < 128; i++) buf[i] = (UChar) i;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      for (i = 0; i < 128; i += 8*nw) {
+        for (j = 0; j < nw; j++) {
+          s.x[j] ^= LOAD64(buf + i + 8*j);
+          STORE64(buf + i + 8*j, s.x[j]);
+        }
+#if defined(ASCON_ASSEMBLER)
+        ascon_asm(&s, rounds[r]);
+#else
+        ascon_c99_pn(&s, rounds[r]);
+#endif
+      }
+    }
+    stop = CYCLES();
+    printf("p%i, separate   : %llu (%08lx)\n", rounds[r],
+      TICKS1000(stop - start, iter*(128/(8*nw))),
+      (unsigned long) (s.w[0][0] ^ s.w[4][1] ^ buf[127]));
+
+    for (i = 0; i < 40; i++) ((uint8_t *) &s)[i] = (uint8_t) i;
+    for (i = 0; i < 128; i++) buf[i] = (UChar) i;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      for (i = 0; i < 128; i += 8*nw) {
+        ascon_c99_encrypt(&s, rounds[r], buf + i, nw, buf + i);
+      }
+    }
+    stop = CYCLES();
+    printf("p%i, fused (C99): %llu (%08lx)\n", rounds[r],
+      TICKS1000(stop - start, iter*(128/(8*nw))),
+      (unsigned long) (s.w[0][0] ^ s.w[4][1] ^ buf[127]));
+
+#if defined(ascon_asm_encrypt)
+    for (i = 0; i < 40; i++) ((uint8_t *) &s)[i] = (uint8_t) i;
+    for (i = 0; i < 128; i++) buf[i] = (UChar) i;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      for (i = 0; i < 128; i += 8*nw) {
+        ascon_asm_encrypt(&s, rounds[r], buf + i, nw, buf + i);
+      }
+    }
+    stop = CYCLES();
+    printf("p%i, fused (ASM): %llu (%08lx)\n", rounds[r],
+      TICKS1000(stop - start, iter*(128/(8*nw))),
+      (unsigned long) (s.w[0][0] ^ s.w[4][1] ^ buf[127]));
+#endif
+  }
+}
@@ -0,0 +1,446 @@
+///////////////////////////////////////////////////////////////////////////////
+// ascon_prf.c: C99 implementation and unit-test of ASCON-PRF/MAC/PRFshort.  //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+typedef union {
+  uint64_t x[5];
+  uint32_t w[5][2];
+  uint8_t b[5][8];
+} State;
+
+
+// The context of the streaming API holds the state, the number of bytes
+// absorbed into or squeezed from the current block, a flag indicating the
+// squeezing phase, and the maximum output length (16 bytes for ASCON-MAC).
+// The state after initialization depends only on the key, which means a
+// context can be initialized once per key and then copied for each message.
+
+typedef struct {
+  State s;
+  int pos;
+  int squeezing;
+  size_t outmax;
+} PrfCtx;
+
+
+// variants
+#define ASCON_PRF 0
+#define ASCON_MAC 1
+
+// initialization vectors
+#define IVPRF  0x80808c0000000000ULL
+#define IVMAC  0x80808c0000000080ULL
+#define IVPRFS 0x80004c8000000000ULL
+
+// input rate (32 bytes = x[0]-x[3]) and output rate (16 bytes = x[0]-x[1])
+#define INRATE  32
+#define OUTRATE 16
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// load/store of a big-endian 64-bit word from/to an unaligned byte-array
+#define LOAD64(p) (((uint64_t) (p)[0] << 56) | ((uint64_t) (p)[1] << 48) | \
+  ((uint64_t) (p)[2] << 40) | ((uint64_t) (p)[3] << 32) | \
+  ((uint64_t) (p)[4] << 24) | ((uint64_t) (p)[5] << 16) | \
+  ((uint64_t) (p)[6] <<  8) | ((uint64_t) (p)[7]))
+#define STORE64(p, x) do { (p)[0] = (uint8_t) ((x) >> 56); \
+  (p)[1] = (uint8_t) ((x) >> 48); (p)[2] = (uint8_t) ((x) >> 40); \
+  (p)[3] = (uint8_t) ((x) >> 32); (p)[4] = (uint8_t) ((x) >> 24); \
+  (p)[5] = (uint8_t) ((x) >> 16); (p)[6] = (uint8_t) ((x) >>  8); \
+  (p)[7] = (uint8_t) (x); } while (0)
+
+// i-th byte of the state in big-endian order (ASCON is specified big-endian,
+// the host is little-endian like MSP430, AVR and x86)
+#define SBYTE(s, i) ((s)->b[(i) >> 3][7 ^ ((i) & 7)])
+
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` times 1000 divided by `n`; the result is a
+// ULLInt since 1000*t exceeds 32 bits on MSP430 after 4.29M ticks
+#define TICKS1000(t, n) ((1000*(ULLInt) (t))/(n))
+
+
+extern void ascon_c99_p12(State *s);
+extern void ascon_c99_absorb(State *s, int nr, const UChar *in, int nw);
+
+#if (defined(__AVR) || defined(__AVR__))
+extern void ascon_avr(State *s, int nr);
+#define ascon_asm_p12(s) ascon_avr((s), 12)
+#define ASCON_ASSEMBLER
+#endif
+
+#if (defined(__MSP430__) || defined(__ICC430__))
+extern void ascon_msp_p12(State *s);
+extern void ascon_msp_absorb(State *s, int nr, const UChar *in, int nw);
+#define ascon_asm_p12(s) ascon_msp_p12((s))
+#define ascon_asm_absorb(s, nr, in, nw) \
+  ascon_msp_absorb((s), (nr), (in), (nw))
+#define ASCON_ASSEMBLER
+#endif
+
+// all permutation calls of ASCON-PRF/MAC/PRFshort have 12 rounds
+#if defined(ASCON_ASSEMBLER)
+#define ASCON_P12(s) ascon_asm_p12((s))
+#else
+#define ASCON_P12(s) ascon_c99_p12((s))
+#endif
+// full 32-byte blocks are absorbed with the fused absorb-and-permute kernel
+// (AVR has no such kernel, the block is XORed in C before the permutation)
+#if defined(ascon_asm_absorb)
+#define ASCON_ABSORB_P12(s, in) ascon_asm_absorb((s), 12, (in), 4)
+#elif defined(ASCON_ASSEMBLER)
+#define ASCON_ABSORB_P12(s, in) do { (s)->x[0] ^= LOAD64(in); \
+  (s)->x[1] ^= LOAD64((in) + 8); (s)->x[2] ^= LOAD64((in) + 16); \
+  (s)->x[3] ^= LOAD64((in) + 24); ascon_asm_p12((s)); } while (0)
+#else
+#define ASCON_ABSORB_P12(s, in) ascon_c99_absorb((s), 12, (in), 4)
+#endif
+
+
+// Initialization of the streaming API. The `variant` is either ASCON_PRF
+// (output of arbitrary length) or ASCON_MAC (128-bit tag).
+
+void ascon_prf_init(PrfCtx *ctx, const UChar *key, int variant)
+{
+  State *s = &ctx->s;
+
+  s->x[0] = (variant == ASCON_MAC) ? IVMAC : IVPRF;
+  s->x[1] = LOAD64(key);
+  s->x[2] = LOAD64(key + 8);
+  s->x[3] = 0;
+  s->x[4] = 0;
+  ASCON_P12(s);
+  ctx->pos = 0;
+  ctx->squeezing = 0;
+  ctx->outmax = (variant == ASCON_MAC) ? 16 : (size_t) -1;
+}
+
+
+// Absorption of a chunk of the message into the 32-byte input rate; the
+// message can be split up into an arbitrary number of chunks of arbitrary
+// length. A full block is permuted as soon as its last byte arrives because
+// the padding always goes into a further block.
+
+void ascon_prf_update(PrfCtx *ctx, const UChar *in, size_t inlen)
+{
+  State *s = &ctx->s;
+  int pos = ctx->pos;
+
+  while ((pos > 0) && (inlen > 0)) {
+    SBYTE(s, pos) ^= *in++;
+    inlen--;
+    if (++pos == INRATE) {
+      ASCON_P12(s);
+      pos = 0;
+    }
+  }
+  while (inlen >= INRATE) {
+    ASCON_ABSORB_P12(s, in);
+    in += INRATE;
+    inlen -= INRATE;
+  }
+  while (inlen > 0) {
+    SBYTE(s, pos) ^= *in++;
+    inlen--;
+    pos++;
+  }
+
+  ctx->pos = pos;
+}
+
+
+// Squeezing of `outlen` bytes from the 16-byte output rate. The first call
+// pads the last message block and adds the domain separation bit. Each block
+// of output is preceded by a permutation. For ASCON-MAC, the total output is
+// truncated to 16 bytes.
+
+void ascon_prf_squeeze(PrfCtx *ctx, UChar *out, size_t outlen)
+{
+  State *s = &ctx->s;
+  int pos = ctx->pos;
+
+  outlen = MIN(outlen, ctx->outmax);
+  ctx->outmax -= outlen;
+  if (!ctx->squeezing) {
+    SBYTE(s, pos) ^= 0x80;
+    s->x[4] ^= 1;
+    ctx->squeezing = 1;
+    pos = OUTRATE;
+  }
+
+  while (outlen > 0) {
+    if (pos == OUTRATE) {
+      ASCON_P12(s);
+      pos = 0;
+    }
+    if ((pos == 0) && (outlen >= OUTRATE)) {
+      STORE64(out, s->x[0]);
+      STORE64(out + 8, s->x[1]);
+      out += OUTRATE;
+      outlen -= OUTRATE;
+      pos = OUTRATE;
+    } else {
+      *out++ = SBYTE(s, pos);
+      outlen--;
+      pos++;
+    }
+  }
+
+  ctx->pos = pos;
+}
+
+
+// Fast path for messages of less than 32 bytes, i.e. messages that fit into
+// a single padded block. The context `kctx` has been initialized with the
+// key beforehand (ascon_prf_init) and is not modified, so it can be used for
+// any number of messages. Computing a tag or an output of up to 16 bytes
+// costs a single permutation and no bookkeeping of the streaming API. The
+// return value is -1 if the message or the output is too long.
+
+int ascon_prf_short_block(UChar *out, size_t outlen, const UChar *in,
+  size_t inlen, const PrfCtx *kctx)
+{
+  State s;
+  size_t i;
+
+  if ((inlen >= INRATE) || (outlen > OUTRATE)) return -1;
+
+  s = kctx->s;
+  for (i = 0; i < inlen; i++) SBYTE(&s, i) ^= in[i];
+  SBYTE(&s, inlen) ^= 0x80;
+  s.x[4] ^= 1;
+  ASCON_P12(&s);
+  if (outlen == OUTRATE) {
+    STORE64(out, s.x[0]);
+    STORE64(out + 8, s.x[1]);
+  } else {
+    for (i = 0; i < outlen; i++) out[i] = SBYTE(&s, i);
+  }
+
+  return 0;
+}
+
+
+// One-shot computation of a 128-bit tag with ASCON-MAC.
+
+void ascon_mac(UChar *tag, const UChar *in, size_t inlen, const UChar *key)
+{
+  PrfCtx ctx;
+
+  ascon_prf_init(&ctx, key, ASCON_MAC);
+  ascon_prf_update(&ctx, in, inlen);
+  ascon_prf_squeeze(&ctx, tag, 16);
+}
+
+
+// One-shot computation of an output of arbitrary length with ASCON-PRF.
+
+void ascon_prf(UChar *out, size_t outlen, const UChar *in, size_t inlen,
+  const UChar *key)
+{
+  PrfCtx ctx;
+
+  ascon_prf_init(&ctx, key, ASCON_PRF);
+  ascon_prf_update(&ctx, in, inlen);
+  ascon_prf_squeeze(&ctx, out, outlen);
+}
+
+
+// ASCON-PRFshort for messages of up to 16 bytes and an output of up to 16
+// bytes. Key, message, and message length (in the IV) are loaded into the
+// state together, so the whole computation is a single permutation plus the
+// key addition. The return value is -1 if message or output is too long.
+
+int ascon_prfshort(UChar *out, size_t outlen, const UChar *in, size_t inlen,
+  const UChar *key)
+{
+  State s;
+  uint64_t k0 = LOAD64(key), k1 = LOAD64(key + 8);
+  size_t i;
+
+  if ((inlen > 16) || (outlen > 16)) return -1;
+
+  s.x[0] = IVPRFS | ((uint64_t) (8*inlen) << 48);
+  s.x[1] = k0;
+  s.x[2] = k1;
+  s.x[3] = s.x[4] = 0;
+  for (i = 0; i < inlen; i++) SBYTE(&s, i + 24) = in[i];
+  ASCON_P12(&s);
+  s.x[3] ^= k0;
+  s.x[4] ^= k1;
+  for (i = 0; i < outlen; i++) out[i] = SBYTE(&s, i + 24);
+
+  return 0;
+}
+
+
+// Print a byte-array in Hex format (the output is limited to the first 64
+// bytes of the byte-array).
+
+static void print_bytes(const char* str, const UChar *bytearray, size_t len)
+{
+  UChar buffer[148], byte;
+  size_t i, j, slen = 0;
+
+  if (str != NULL) {
+    slen = MIN(16, strlen(str));
+    memcpy(buffer, str, slen);
+  }
+
+  j = slen;
+  for (i = 0; i < MIN(64, len); i++) {
+    byte = bytearray[i] >> 4;
+    // replace 87 by 55 to get uppercase letters
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+    byte = bytearray[i] & 0xf;
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+  }
+  if (len > 64) {
+    buffer[j] = buffer[j+1] = buffer[j+2] = '.';
+    j += 3;
+  }
+  buffer[j] = '\0';
+
+  printf("%s\n", buffer);
+}
+
+
+// Simple test function for ASCON-PRF, ASCON-MAC, and ASCON-PRFshort. The 1st
+// test computes the tag of the empty message and of a 16-byte message with
+// ASCON-MAC (streaming and single-block fast path) and ASCON-PRFshort, the
+// 2nd test absorbs a 45-byte message in chunks of 5 and 40 bytes and
+// squeezes 40 bytes from the PRF in chunks of 7 and 33 bytes.
+
+void ascon_test_prf(void)
+{
+  UChar key[16], msg[48], out[48], out2[48];
+  PrfCtx kctx, ctx;
+  int i;
+
+  for (i = 0; i < 16; i++) key[i] = (UChar) i;
+  for (i = 0; i < 48; i++) msg[i] = (UChar) i;
+
+  // 1st test: short messages
+
+  printf("Test 1 - C99 implementation:\n");
+  ascon_mac(out, msg, 0, key);
+  print_bytes("MAC:      ", out, 16);
+  ascon_prf_init(&kctx, key, ASCON_MAC);
+  ascon_prf_short_block(out, 16, msg, 0, &kctx);
+  print_bytes("MAC:      ", out, 16);
+  ascon_mac(out, msg, 16, key);
+  print_bytes("MAC:      ", out, 16);
+  ascon_prf_short_block(out, 16, msg, 16, &kctx);
+  print_bytes("MAC:      ", out, 16);
+  ascon_prfshort(out, 16, msg, 0, key);
+  print_bytes("PRFshort: ", out, 16);
+  ascon_prfshort(out, 16, msg, 16, key);
+  print_bytes("PRFshort: ", out, 16);
+
+  // 2nd test: streaming absorb and squeeze
+
+  printf("Test 2 - C99 implementation:\n");
+  ascon_prf(out, 40, msg, 45, key);
+  print_bytes("PRF:      ", out, 40);
+  ascon_prf_init(&ctx, key, ASCON_PRF);
+  ascon_prf_update(&ctx, msg, 5);
+  ascon_prf_update(&ctx, msg + 5, 40);
+  ascon_prf_squeeze(&ctx, out2, 7);
+  ascon_prf_squeeze(&ctx, out2 + 7, 33);
+  print_bytes("PRF:      ", out2, 40);
+
+  // Expected result
+  // ---------------
+  // Test 1 - C99 implementation:
+  // MAC:      eb1af688825d66bf2d53e135f9323315
+  // MAC:      eb1af688825d66bf2d53e135f9323315
+  // MAC:      a7915e83ee1aa71422cfd90868e22dc2
+  // MAC:      a7915e83ee1aa71422cfd90868e22dc2
+  // PRFshort: 5006eb1808193809f981151b19e59299
+  // PRFshort: bd03ea334bebefc4d7ddaef4b1df1485
+  // Test 2 - C99 implementation:
+  // PRF:      b7445eaf4f1396044d30fbcdde9d0b6718a9adf28165918bc48666223bf66488d0cdf52dfdc62a18
+  // PRF:      b7445eaf4f1396044d30fbcdde9d0b6718a9adf28165918bc48666223bf66488d0cdf52dfdc62a18
+}
+
+
+// Benchmark of the short-input paths for messages of 1 to 32 bytes. For each
+// length, the 128-bit tag is computed `iter` times with ascon_mac (generic
+// path incl. initialization), ascon_prf_short_block (key-dependent state
+// precomputed, up to 31 bytes), and ascon_prfshort (up to 16 bytes), and
+// ascon_aead_encrypt (ASCON128) is timed for comparison. The printed values
+// are the number of CYCLES() ticks per call times 1000 (0 if a path does not
+// support the length).
+
+extern void ascon_aead_encrypt(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant);
+
+void ascon_bench_prf(long iter)
+{
+  UChar key[16], msg[32], tag[16], ct[32];
+  unsigned long start, t[4];
+  PrfCtx kctx;
+  size_t len;
+  long n;
+  int i;
+
+  for (i = 0; i < 16; i++) key[i] = (UChar) i;
+  for (i = 0; i < 32; i++) msg[i] = (UChar) i;
+  ascon_prf_init(&kctx, key, ASCON_MAC);
+
+  printf("len: mac short_block prfshort aead\n");
+  for (len = 1; len <= 32; len++) {
+    start = CYCLES();
+    for (n = 0; n < iter; n++) ascon_mac(tag, msg, len, key);
+    t[0] = CYCLES() - start;
+    t[1] = t[2] = 0;
+    if (len < INRATE) {
+      start = CYCLES();
+      for (n = 0; n < iter; n++) {
+        ascon_prf_short_block(tag, 16, msg, len, &kctx);
+      }
+      t[1] = CYCLES() - start;
+    }
+    if (len <= 16) {
+      start = CYCLES();
+      for (n = 0; n < iter; n++) ascon_prfshort(tag, 16, msg, len, key);
+      t[2] = CYCLES() - start;
+    }
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      ascon_aead_encrypt(ct, tag, msg, len, NULL, 0, key, key, 0);
+    }
+    t[3] = CYCLES() - start;
+    printf("%2i: %llu %llu %llu %llu\n", (int) len, TICKS1000(t[0], iter),
+      TICKS1000(t[1], iter), TICKS1000(t[2], iter), TICKS1000(t[3], iter));
+  }
+}
@@ -0,0 +1,1028 @@
+///////////////////////////////////////////////////////////////////////////////
+// elephant_aead.c: C99 implementation and unit-test of Elephant AEAD (v2).  //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+// The key context of the parallel path (elephant_setkey) is available on all
+// targets. On the host, the masks of distant blocks are computed with jump-
+// ahead tables of the mask LFSR, which take 360 kB of RAM and are built once
+// by the first call of elephant_setkey (before any worker thread is started).
+// These tables are host-only; on the MSP430 the key context caches fewer
+// start masks and derives them by stepping the mask LFSR.
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+
+// variants
+#define DUMBO    0  // Spongent-pi[160], 20-byte blocks, 8-byte tag
+#define JUMBO    1  // Spongent-pi[176], 22-byte blocks, 8-byte tag
+#define DELIRIUM 2  // Keccak-f[200], 25-byte blocks, 16-byte tag
+
+// maximum size of a block (i.e. the state of the permutation), size of the
+// nonce, and maximum size of the tag in bytes
+#define MAXBLK 25
+#define NPUBSZ 12
+#define MAXTAG 16
+
+// number of blocks that are permuted together with the `perm_xn` function
+// of a variant; the input blocks and the masks of a chunk are kept on the
+// stack (the bitsliced Spongent-pi[160] of elephant_multi.c permutes up to 64
+// blocks at once, which pays off for larger chunks)
+#if !defined(ELEPHANT_CHUNK)
+#if (defined(__MSP430__) || defined(__ICC430__))
+#define ELEPHANT_CHUNK 8
+#else
+#define ELEPHANT_CHUNK 32
+#endif
+#endif
+
+// number of blocks of a range of the parallel path (a power of 2), and
+// maximum number of ranges that are processed by one parallel loop (which is
+// also the number of start masks cached in the key context, i.e. 1600 bytes
+// on the host and 100 bytes on the MSP430)
+#define ELEPHANT_RANGEBITS 10
+#define ELEPHANT_RANGE (1 << ELEPHANT_RANGEBITS)
+#if (defined(__MSP430__) || defined(__ICC430__))
+#define ELEPHANT_MAXRANGES 4
+#else
+#define ELEPHANT_MAXRANGES 64
+#endif
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` times 1000 divided by `n`; the result is a
+// ULLInt since 1000*t exceeds 32 bits on MSP430 after 4.29M ticks
+#define TICKS1000(t, n) ((1000*(ULLInt) (t))/(n))
+
+// ratio of the tick counts `a` and `b` in %, or 0 if `b` is 0 (which can
+// happen on a host due to the resolution of clock())
+#define PERCENT(a, b) ((b) ? (100*(ULLInt) (a))/(b) : 0ULL)
+
+
+extern void permutation_C99_V2(uint8_t* state);
+extern void permutation_C99_xN(uint8_t* states, int n);
+extern void permutation_C99_bs(uint8_t* states, int n);
+extern void permutation176_C99_V2(uint8_t* state);
+extern void permutation176_C99_xN(uint8_t* states, int n);
+extern void keccak200_c99_V2(uint8_t *a);
+
+#if (defined(__MSP430__) || defined(__ICC430__))
+extern void spongent_msp(uint8_t s[20]);
+extern void spongent176_msp(uint8_t s[22]);
+extern void keccak200_msp(uint8_t *state);
+#define SPONGENT_ASSEMBLER
+#else
+#define ELEPHANT_JUMPTABLE
+#endif
+
+
+// Steps of the LFSRs that update the mask (phi_1 of the three variants).
+// They map (x_0, ..., x_{bs-1}) to (x_1, ..., x_{bs-1}, f(x_0, ...)), i.e.
+// only one byte is computed per step.
+
+static void dumbo_lfsr(UChar *out, const UChar *in)
+{
+  UChar tmp = ((in[0] << 3) | (in[0] >> 5)) ^ (in[3] << 7) ^ (in[13] >> 7);
+
+  memmove(out, in + 1, 19);
+  out[19] = tmp;
+}
+
+
+static void jumbo_lfsr(UChar *out, const UChar *in)
+{
+  UChar tmp = ((in[0] << 1) | (in[0] >> 7)) ^ (in[3] << 7) ^ (in[19] >> 7);
+
+  memmove(out, in + 1, 21);
+  out[21] = tmp;
+}
+
+
+static void delirium_lfsr(UChar *out, const UChar *in)
+{
+  UChar tmp = ((in[0] << 1) | (in[0] >> 7)) ^ ((in[2] << 1) | (in[2] >> 7))
+    ^ (in[13] << 1);
+
+  memmove(out, in + 1, 24);
+  out[24] = tmp;
+}
+
+
+// Parameters of the three variants. They use the same mode and only differ
+// in the permutation (and thus the block size), the mask LFSR, and the size
+// of the tag. The mode uses the Assembler permutations when available (one
+// block after the other), otherwise the C99 permutations of elephant_perm.c
+// and keccak200_perm.c, whereby `perm_xn` permutes `n` blocks (bitsliced for
+// Spongent-pi[160], see elephant_multi.c, and with interleaved rounds for
+// Spongent-pi[176]).
+
+typedef struct {
+  int bs;   // block size in bytes
+  int ts;   // tag size in bytes
+  void (*lfsr)(UChar *out, const UChar *in);
+  void (*perm)(uint8_t *state);
+  void (*perm_xn)(uint8_t *states, int n);
+} ElephantParams;
+
+#if defined(SPONGENT_ASSEMBLER)
+
+static void spongent_msp_xn(uint8_t *states, int n)
+{
+  int j;
+
+  for (j = 0; j < n; j++) spongent_msp(states + 20*j);
+}
+
+static void spongent176_msp_xn(uint8_t *states, int n)
+{
+  int j;
+
+  for (j = 0; j < n; j++) spongent176_msp(states + 22*j);
+}
+
+static void keccak200_msp_xn(uint8_t *states, int n)
+{
+  int j;
+
+  for (j = 0; j < n; j++) keccak200_msp(states + 25*j);
+}
+
+static const ElephantParams PARAMS[3] = {
+  { 20,  8, dumbo_lfsr, spongent_msp, spongent_msp_xn },          // Dumbo
+  { 22,  8, jumbo_lfsr, spongent176_msp, spongent176_msp_xn },    // Jumbo
+  { 25, 16, delirium_lfsr, keccak200_msp, keccak200_msp_xn }      // Delirium
+};
+
+#else
+
+static void keccak200_c99_xN(uint8_t *states, int n)
+{
+  int j;
+
+  for (j = 0; j < n; j++) keccak200_c99_V2(states + 25*j);
+}
+
+static const ElephantParams PARAMS[3] = {
+  { 20,  8, dumbo_lfsr, permutation_C99_V2, permutation_C99_bs },
+  { 22,  8, jumbo_lfsr, permutation176_C99_V2, permutation176_C99_xN },
+  { 25, 16, delirium_lfsr, keccak200_c99_V2, keccak200_c99_xN }
+};
+
+#endif
+
+
+// XOR of `len` bytes of `in` to `out`.
+
+static void elephant_xor(UChar *out, const UChar *in, size_t len)
+{
+  size_t i;
+
+  for (i = 0; i < len; i++) out[i] ^= in[i];
+}
+
+
+// Padded block `i` of the associated data; block 0 consists of the nonce
+// and the first bs-12 bytes of the associated data. If the nonce plus the
+// associated data is a multiple of the block size, the last block is only
+// padding.
+
+static void elephant_ad_block(UChar *out, const UChar *ad, size_t adlen,
+  const UChar *npub, size_t i, int bs)
+{
+  size_t pos = 0, off = 0, len;
+
+  memset(out, 0, bs);
+  if (i == 0) {
+    memcpy(out, npub, NPUBSZ);
+    pos = NPUBSZ;
+  } else {
+    off = i*bs - NPUBSZ;
+  }
+  len = MIN(bs - pos, adlen - off);
+  memcpy(out + pos, ad + off, len);
+  if (pos + len < (size_t) bs) out[pos+len] = 0x01;
+}
+
+
+// Padded block `i` of the ciphertext (same padding as above).
+
+static void elephant_c_block(UChar *out, const UChar *c, size_t clen,
+  size_t i, int bs)
+{
+  size_t off = i*bs, len = MIN((size_t) bs, clen - off);
+
+  memset(out, 0, bs);
+  memcpy(out, c + off, len);
+  if (len < (size_t) bs) out[len] = 0x01;
+}
+
+
+// Encryption or decryption of the blocks `b0` to `b0+nb-1` of `in`, whereby
+// `mask` is the mask of block `b0`, i.e. phi_1^b0 applied to the expanded
+// key. Block i is encrypted with P(N || 0 ^ M_i ^ M_{i+1}) ^ M_i ^ M_{i+1}.
+// The key-stream blocks of a chunk are independent and permuted together.
+// The output `out` can be the same buffer as the input `in`.
+
+static void elephant_enc_range(UChar *out, const UChar *in, size_t len,
+  const UChar *npub, const UChar *mask, size_t b0, size_t nb,
+  const ElephantParams *p)
+{
+  UChar m[ELEPHANT_CHUNK+1][MAXBLK], s[ELEPHANT_CHUNK*MAXBLK];
+  int j, bs = p->bs;
+  size_t i, n, off;
+
+  memcpy(m[0], mask, bs);
+  while (nb > 0) {
+    n = MIN(nb, ELEPHANT_CHUNK);
+    for (j = 0; j < (int) n; j++) {
+      p->lfsr(m[j+1], m[j]);
+      memset(s + bs*j, 0, bs);
+      memcpy(s + bs*j, npub, NPUBSZ);
+      elephant_xor(s + bs*j, m[j], bs);
+      elephant_xor(s + bs*j, m[j+1], bs);
+    }
+    p->perm_xn(s, (int) n);
+    for (j = 0; j < (int) n; j++) {
+      elephant_xor(s + bs*j, m[j], bs);
+      elephant_xor(s + bs*j, m[j+1], bs);
+      off = (b0 + j)*bs;
+      for (i = 0; i < MIN((size_t) bs, len - off); i++) {
+        out[off+i] = in[off+i] ^ s[bs*j+i];
+      }
+    }
+    memcpy(m[0], m[n], bs);
+    b0 += n;
+    nb -= n;
+  }
+}
+
+
+// Absorption of the blocks `b0` to `b0+nb-1` into the accumulator `acc`,
+// whereby `mask` is the mask of block `b0`. Ciphertext block i (for i < nc)
+// contributes P(C_i ^ M_i ^ M_{i+2}) ^ M_i ^ M_{i+2} and associated data
+// block i (for 0 < i < na) contributes P(A_i ^ M_i) ^ M_i; block A_0 is
+// added by the caller. All these blocks are independent and permuted
+// together.
+
+static void elephant_mac_range(UChar *acc, const UChar *c, size_t clen,
+  const UChar *ad, size_t adlen, const UChar *npub, const UChar *mask,
+  size_t b0, size_t nb, const ElephantParams *p)
+{
+  UChar m[ELEPHANT_CHUNK+2][MAXBLK], s[2*ELEPHANT_CHUNK*MAXBLK];
+  int j, k, ns, bs = p->bs;
+  size_t nc = 1 + clen/bs, na = 1 + (NPUBSZ + adlen)/bs, i, n;
+
+  memcpy(m[0], mask, bs);
+  p->lfsr(m[1], m[0]);
+  while (nb > 0) {
+    n = MIN(nb, ELEPHANT_CHUNK);
+    for (j = 0, ns = 0; j < (int) n; j++) {
+      p->lfsr(m[j+2], m[j+1]);
+      i = b0 + j;
+      if (i < nc) {
+        elephant_c_block(s + bs*ns, c, clen, i, bs);
+        elephant_xor(s + bs*ns, m[j], bs);
+        elephant_xor(s + bs*ns, m[j+2], bs);
+        ns++;
+      }
+      if (i > 0 && i < na) {
+        elephant_ad_block(s + bs*ns, ad, adlen, npub, i, bs);
+        elephant_xor(s + bs*ns, m[j], bs);
+        ns++;
+      }
+    }
+    p->perm_xn(s, ns);
+    for (j = 0, k = 0; j < (int) n; j++) {
+      i = b0 + j;
+      if (i < nc) {
+        elephant_xor(s + bs*k, m[j], bs);
+        elephant_xor(s + bs*k, m[j+2], bs);
+        elephant_xor(acc, s + bs*k, bs);
+        k++;
+      }
+      if (i > 0 && i < na) {
+        elephant_xor(s + bs*k, m[j], bs);
+        elephant_xor(acc, s + bs*k, bs);
+        k++;
+      }
+    }
+    memcpy(m[0], m[n], bs);
+    memcpy(m[1], m[n+1], bs);
+    b0 += n;
+    nb -= n;
+  }
+}
+
+
+// Computation of the tag (64 or 128 bits) from the accumulator `acc` (which
+// contains the sum of all permuted blocks but A_0) and the expanded key `ek`.
+
+static void elephant_tag(UChar *tag, UChar *acc, const UChar *ad,
+  size_t adlen, const UChar *npub, const UChar *ek, const ElephantParams *p)
+{
+  UChar a0[MAXBLK];
+
+  elephant_ad_block(a0, ad, adlen, npub, 0, p->bs);
+  elephant_xor(acc, a0, p->bs);
+  elephant_xor(acc, ek, p->bs);
+  p->perm(acc);
+  elephant_xor(acc, ek, p->bs);
+  memcpy(tag, acc, p->ts);
+}
+
+
+// Expanded key, i.e. the permutation of the key padded with zeros.
+
+static void elephant_expand(UChar *ek, const UChar *key,
+  const ElephantParams *p)
+{
+  memset(ek, 0, p->bs);
+  memcpy(ek, key, 16);
+  p->perm(ek);
+}
+
+
+// Sequential computation of the tag over the associated data and the
+// ciphertext.
+
+static void elephant_mac(UChar *tag, const UChar *c, size_t clen,
+  const UChar *ad, size_t adlen, const UChar *npub, const UChar *ek,
+  const ElephantParams *p)
+{
+  size_t nc = 1 + clen/p->bs, na = 1 + (NPUBSZ + adlen)/p->bs;
+  UChar acc[MAXBLK];
+
+  memset(acc, 0, p->bs);
+  elephant_mac_range(acc, c, clen, ad, adlen, npub, ek, 0, MAX(nc, na), p);
+  elephant_tag(tag, acc, ad, adlen, npub, ek, p);
+}
+
+
+// One-shot encryption; the `variant` is DUMBO, JUMBO, or DELIRIUM, and the
+// ciphertext `c` can be the same buffer as the plaintext `m`. Unlike the
+// reference code, which processes a message block, a ciphertext block, and
+// an associated-data block in each iteration, the message is first
+// encrypted and then authenticated; the result is the same since each block
+// is permuted independently.
+
+void elephant_aead_encrypt(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant)
+{
+  const ElephantParams *p = &PARAMS[variant];
+  UChar ek[MAXBLK];
+
+  elephant_expand(ek, key, p);
+  elephant_enc_range(c, m, mlen, npub, ek, 0, (mlen + p->bs - 1)/p->bs, p);
+  elephant_mac(tag, c, mlen, ad, adlen, npub, ek, p);
+}
+
+
+// One-shot decryption. Elephant is an encrypt-then-MAC scheme, i.e. the tag
+// is verified (in constant time) before anything is decrypted; a forgery is
+// rejected with -1 and `m` is not modified.
+
+int elephant_aead_decrypt(UChar *m, const UChar *c, size_t clen,
+  const UChar *tag, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant)
+{
+  const ElephantParams *p = &PARAMS[variant];
+  UChar ek[MAXBLK], t[MAXTAG], diff = 0;
+  int i;
+
+  elephant_expand(ek, key, p);
+  elephant_mac(t, c, clen, ad, adlen, npub, ek, p);
+  for (i = 0; i < p->ts; i++) diff |= t[i] ^ tag[i];
+  if (diff != 0) return -1;
+  elephant_enc_range(m, c, clen, npub, ek, 0, (clen + p->bs - 1)/p->bs, p);
+
+  return 0;
+}
+
+
+// Jump-ahead of the mask LFSR. Since phi_1 is linear, phi_1^n is a binary
+// matrix (from 160x160 for Dumbo up to 200x200 for Delirium), and phi_1^n(x)
+// is computed with square-and-multiply from the matrices phi_1^(2^k) for k <
+// ELEPHANT_JUMPBITS, i.e. with at most one matrix-vector product per bit of
+// `n`. Column i of matrix k (the image of unit vector i) is stored in
+// phi_pow[variant][k][i]. The tables are key-independent and have a size of
+// up to 5000 bytes per matrix, so they are only built (once) on the host; on
+// the MSP430, phi_1^n(x) is computed with n steps of the LFSR.
+
+#if defined(ELEPHANT_JUMPTABLE)
+
+#if !defined(ELEPHANT_JUMPBITS)
+#define ELEPHANT_JUMPBITS 24
+#endif
+
+static UChar phi_pow[3][ELEPHANT_JUMPBITS][8*MAXBLK][MAXBLK];
+static int phi_init[3] = { 0, 0, 0 };
+
+
+// Matrix-vector product out = M*in; `out` can be the same as `in`.
+
+static void elephant_matvec(UChar *out, UChar (*mat)[MAXBLK],
+  const UChar *in, int bs)
+{
+  UChar tmp[MAXBLK];
+  int i;
+
+  memset(tmp, 0, bs);
+  for (i = 0; i < 8*bs; i++) {
+    if ((in[i >> 3] >> (i & 7)) & 1) elephant_xor(tmp, mat[i], bs);
+  }
+  memcpy(out, tmp, bs);
+}
+
+
+// Computation of the matrices phi_1^(2^k) of a variant by repeated squaring.
+// Only elephant_setkey calls this function, i.e. the tables are complete
+// before elephant_par starts any worker thread; the critical section makes
+// concurrent calls of elephant_setkey from several threads safe.
+
+static void elephant_init_jump(int variant)
+{
+  const ElephantParams *p = &PARAMS[variant];
+  UChar (*pw)[8*MAXBLK][MAXBLK] = phi_pow[variant];
+  int i, k;
+
+#if defined(_OPENMP)
+#pragma omp critical(elephant_jump)
+#endif
+  if (!phi_init[variant]) {
+    for (i = 0; i < 8*p->bs; i++) {
+      memset(pw[0][i], 0, p->bs);
+      pw[0][i][i >> 3] = (UChar) (1 << (i & 7));
+      p->lfsr(pw[0][i], pw[0][i]);
+    }
+    for (k = 1; k < ELEPHANT_JUMPBITS; k++) {
+      for (i = 0; i < 8*p->bs; i++) {
+        elephant_matvec(pw[k][i], pw[k-1], pw[k-1][i], p->bs);
+      }
+    }
+    phi_init[variant] = 1;
+  }
+}
+
+
+// Jump-ahead out = phi_1^n(in) in O(log n); `out` can be the same as `in`.
+// elephant_init_jump must have been called before for the variant.
+
+static void elephant_jump(UChar *out, const UChar *in, size_t n,
+  int variant)
+{
+  UChar (*pw)[8*MAXBLK][MAXBLK] = phi_pow[variant];
+  int k, bs = PARAMS[variant].bs;
+
+  memcpy(out, in, bs);
+  for (k = 0; k < ELEPHANT_JUMPBITS && n > 0; k++, n >>= 1) {
+    if (n & 1) elephant_matvec(out, pw[k], out, bs);
+  }
+  // remaining multiples of 2^ELEPHANT_JUMPBITS
+  for (; n > 0; n--) {
+    elephant_matvec(out, pw[ELEPHANT_JUMPBITS-1], out, bs);
+    elephant_matvec(out, pw[ELEPHANT_JUMPBITS-1], out, bs);
+  }
+}
+
+#else
+
+static void elephant_jump(UChar *out, const UChar *in, size_t n,
+  int variant)
+{
+  memcpy(out, in, PARAMS[variant].bs);
+  for (; n > 0; n--) PARAMS[variant].lfsr(out, out);
+}
+
+#endif  // defined(ELEPHANT_JUMPTABLE)
+
+
+// Key context for the parallel path. It caches the variant, the expanded key
+// and the masks at the start of the first ELEPHANT_MAXRANGES ranges, i.e.
+// the mask table is computed once per key and then reused for all messages
+// under this key. The table is filled on demand (up to the last range of the
+// longest message so far), so that the set-up of a key context costs only
+// one permutation. Since ELEPHANT_RANGE is a power of 2, each table entry is
+// obtained from the previous one with a single matrix-vector product (or with
+// ELEPHANT_RANGE steps of the LFSR on the MSP430).
+
+typedef struct ElephantKey {
+  int variant;
+  UChar ek[MAXBLK];
+  UChar rmask[ELEPHANT_MAXRANGES][MAXBLK];
+  int nrm;  // number of valid entries of rmask
+} ElephantKey;
+
+
+// Size of the key context in bytes, which depends on the target (see
+// ELEPHANT_MAXRANGES). Other source files only see the incomplete type
+// `struct ElephantKey` and use this function to allocate a key context.
+
+size_t elephant_keysize(void)
+{
+  return sizeof(ElephantKey);
+}
+
+
+// Set-up of a key context for `variant`: the key is expanded with the
+// permutation (which is also the first start mask of the table), and the
+// rest of the mask table is computed on demand by the parallel path. On the
+// host, the first call for a variant also builds the jump-ahead tables of
+// its mask LFSR (360 kB of static RAM for all three variants, in an OpenMP
+// critical section). Since elephant_par reads these tables from its worker
+// threads without locking, elephant_setkey has to be called (and must have
+// returned) before a key context is used for encryption or decryption.
+
+void elephant_setkey(ElephantKey *dk, const UChar *key, int variant)
+{
+#if defined(ELEPHANT_JUMPTABLE)
+  elephant_init_jump(variant);
+#endif
+  dk->variant = variant;
+  elephant_expand(dk->ek, key, &PARAMS[variant]);
+  memcpy(dk->rmask[0], dk->ek, PARAMS[variant].bs);
+  dk->nrm = 1;
+}
+
+
+// Extension of the mask table of the key context to `nr` entries.
+
+static void elephant_extend(ElephantKey *dk, int nr)
+{
+  for (; dk->nrm < nr; dk->nrm++) {
+    elephant_jump(dk->rmask[dk->nrm], dk->rmask[dk->nrm-1], ELEPHANT_RANGE,
+      dk->variant);
+  }
+}
+
+
+// Mask of block `b` (which is a multiple of ELEPHANT_RANGE); the masks
+// beyond the cached table (which has to be complete in this case) are
+// derived with a jump-ahead from the last entry.
+
+static void elephant_range_mask(UChar *mask, const ElephantKey *dk,
+  size_t b)
+{
+  size_t r = b >> ELEPHANT_RANGEBITS;
+
+  if (r < ELEPHANT_MAXRANGES) {
+    memcpy(mask, dk->rmask[r], PARAMS[dk->variant].bs);
+  } else {
+    elephant_jump(mask, dk->rmask[ELEPHANT_MAXRANGES-1],
+      (r - (ELEPHANT_MAXRANGES - 1)) << ELEPHANT_RANGEBITS, dk->variant);
+  }
+}
+
+
+// Parallel path for long messages. The blocks are split into ranges of
+// ELEPHANT_RANGE blocks, whose start masks are taken from the key context
+// (or computed with a jump-ahead), i.e. each range is independent of all
+// other ranges. The ranges are processed by worker threads (via OpenMP when
+// compiled with -fopenmp, otherwise one after the other), and each range
+// permutes ELEPHANT_CHUNK blocks together. The partial accumulators of the
+// ranges are combined in a fixed order, so the result is identical to the
+// sequential path. The mask table of the key context is extended before the
+// worker threads are started.
+
+static void elephant_par(UChar *acc, UChar *out, const UChar *in,
+  size_t len, const UChar *ad, size_t adlen, const UChar *npub,
+  ElephantKey *dk, int mac)
+{
+  const ElephantParams *p = &PARAMS[dk->variant];
+  UChar part[ELEPHANT_MAXRANGES][MAXBLK];
+  size_t nb, b0, nr, bs = p->bs;
+  int r;
+
+  if (mac) nb = MAX(1 + len/bs, 1 + (NPUBSZ + adlen)/bs);
+  else nb = (len + bs - 1)/bs;
+  for (b0 = 0; b0 < nb; b0 += nr*ELEPHANT_RANGE) {
+    nr = MIN(ELEPHANT_MAXRANGES,
+      (nb - b0 + ELEPHANT_RANGE - 1)/ELEPHANT_RANGE);
+    memset(part, 0, sizeof(part));
+    elephant_extend(dk, (int) MIN(ELEPHANT_MAXRANGES,
+      b0/ELEPHANT_RANGE + nr));
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (r = 0; r < (int) nr; r++) {
+      size_t rb = b0 + r*ELEPHANT_RANGE, rn = MIN(ELEPHANT_RANGE, nb - rb);
+      UChar mask[MAXBLK];
+      elephant_range_mask(mask, dk, rb);
+      if (mac) {
+        elephant_mac_range(part[r], in, len, ad, adlen, npub, mask, rb, rn,
+          p);
+      } else {
+        elephant_enc_range(out, in, len, npub, mask, rb, rn, p);
+      }
+    }
+    if (mac) for (r = 0; r < (int) nr; r++) elephant_xor(acc, part[r], bs);
+  }
+}
+
+
+// Encryption using the parallel path and a key context, which can be reused
+// for many messages (but not by several callers at the same time since the
+// mask table may be extended); the output is the same as that of
+// elephant_aead_encrypt with the variant of the key context.
+
+void elephant_aead_encrypt_dk(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  ElephantKey *dk)
+{
+  UChar acc[MAXBLK];
+
+  elephant_par(NULL, c, m, mlen, NULL, 0, npub, dk, 0);
+  memset(acc, 0, MAXBLK);
+  elephant_par(acc, NULL, c, mlen, ad, adlen, npub, dk, 1);
+  elephant_tag(tag, acc, ad, adlen, npub, dk->ek, &PARAMS[dk->variant]);
+}
+
+
+// Decryption using the parallel path and a key context (the tag is also
+// verified before anything is decrypted).
+
+int elephant_aead_decrypt_dk(UChar *m, const UChar *c, size_t clen,
+  const UChar *tag, const UChar *ad, size_t adlen, const UChar *npub,
+  ElephantKey *dk)
+{
+  UChar acc[MAXBLK], t[MAXTAG], diff = 0;
+  int i;
+
+  memset(acc, 0, MAXBLK);
+  elephant_par(acc, NULL, c, clen, ad, adlen, npub, dk, 1);
+  elephant_tag(t, acc, ad, adlen, npub, dk->ek, &PARAMS[dk->variant]);
+  for (i = 0; i < PARAMS[dk->variant].ts; i++) diff |= t[i] ^ tag[i];
+  if (diff != 0) return -1;
+  elephant_par(NULL, m, c, clen, NULL, 0, npub, dk, 0);
+
+  return 0;
+}
+
+
+// One-shot encryption using the parallel path.
+
+void elephant_aead_encrypt_par(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant)
+{
+  ElephantKey dk;
+
+  elephant_setkey(&dk, key, variant);
+  elephant_aead_encrypt_dk(c, tag, m, mlen, ad, adlen, npub, &dk);
+}
+
+
+// One-shot decryption using the parallel path.
+
+int elephant_aead_decrypt_par(UChar *m, const UChar *c, size_t clen,
+  const UChar *tag, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant)
+{
+  ElephantKey dk;
+
+  elephant_setkey(&dk, key, variant);
+  return elephant_aead_decrypt_dk(m, c, clen, tag, ad, adlen, npub, &dk);
+}
+
+
+// Print a byte-array in Hex format (the output is limited to the first 64
+// bytes of the byte-array).
+
+static void print_bytes(const char* str, const UChar *bytearray, size_t len)
+{
+  UChar buffer[148], byte;
+  size_t i, j, slen = 0;
+
+  if (str != NULL) {
+    slen = MIN(16, strlen(str));
+    memcpy(buffer, str, slen);
+  }
+
+  j = slen;
+  for (i = 0; i < MIN(64, len); i++) {
+    byte = bytearray[i] >> 4;
+    // replace 87 by 55 to get uppercase letters
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+    byte = bytearray[i] & 0xf;
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+  }
+  if (len > 64) {
+    buffer[j] = buffer[j+1] = buffer[j+2] = '.';
+    j += 3;
+  }
+  buffer[j] = '\0';
+
+  printf("%s\n", buffer);
+}
+
+
+// Simple test function for Dumbo, Jumbo, and Delirium. The 1st test uses the
+// key and nonce of the NIST KAT files with empty message and associated
+// data, the 2nd test encrypts a 41-byte message with 32 bytes of associated
+// data (in place) and decrypts it again, the 3rd test checks that a tampered
+// ciphertext is rejected without touching the output buffer, the 4th test
+// compares the parallel path with the sequential one for several lengths
+// around the block and range boundaries, and the 5th test checks the jump-
+// ahead of the mask LFSR. The 4th and 5th test need 135 kB of buffers and
+// jumps over more than 2^24 blocks, so they are only run on the host.
+
+void elephant_test_aead(int variant)
+{
+#if !defined(SPONGENT_ASSEMBLER)
+  static const size_t jmp[6] = { 0, 1, 1023, 1024, 65537, 100000 };
+  static UChar msg[45101], ct1[45101], ct2[45101];
+  UChar tag2[MAXTAG], x[MAXBLK], y[MAXBLK];
+  size_t len[8], n, bs = PARAMS[variant].bs;
+  ElephantKey dk;
+  int alen, err = 0;
+#endif
+  UChar key[16], npub[NPUBSZ], ad[48], buf[48], tag[MAXTAG];
+  int i, res, ts = PARAMS[variant].ts;
+
+  for (i = 0; i < 16; i++) key[i] = (UChar) i;
+  for (i = 0; i < NPUBSZ; i++) npub[i] = (UChar) i;
+  for (i = 0; i < 48; i++) ad[i] = (UChar) i;
+  memset(buf, 0, sizeof(buf));
+
+  // 1st test: empty message and empty associated data
+
+  printf("Test 1 - C99 implementation:\n");
+  elephant_aead_encrypt(buf, tag, buf, 0, ad, 0, npub, key, variant);
+  print_bytes("Tag: ", tag, ts);
+
+  // 2nd test: in-place encryption and decryption
+
+  printf("Test 2 - C99 implementation:\n");
+  for (i = 0; i < 41; i++) buf[i] = (UChar) i;
+  elephant_aead_encrypt(buf, tag, buf, 41, ad, 32, npub, key, variant);
+  print_bytes("CT:  ", buf, 41);
+  print_bytes("Tag: ", tag, ts);
+  res = elephant_aead_decrypt(buf, buf, 41, tag, ad, 32, npub, key, variant);
+  print_bytes("PT:  ", buf, 41);
+  printf("Verification: %s\n", (res == 0) ? "ok" : "failed");
+
+  // 3rd test: a flipped bit in the ciphertext must be detected before the
+  // decryption, i.e. the buffer still contains the (tampered) ciphertext
+
+  printf("Test 3 - C99 implementation:\n");
+  elephant_aead_encrypt(buf, tag, buf, 41, ad, 32, npub, key, variant);
+  buf[40] ^= 0x01;
+  res = elephant_aead_decrypt(buf, buf, 41, tag, ad, 32, npub, key, variant);
+  printf("Verification: %s\n", (res == 0) ? "ok" : "failed");
+  print_bytes("CT:  ", buf, 41);
+
+#if !defined(SPONGENT_ASSEMBLER)
+  // 4th test: parallel path with a key context that is reused for all
+  // messages (the lengths depend on the block size)
+
+  printf("Test 4 - C99 parallel implementation:\n");
+  len[0] = 0; len[1] = 1; len[2] = bs - 1; len[3] = bs; len[4] = bs + 1;
+  len[5] = ELEPHANT_RANGE*bs - 1; len[6] = ELEPHANT_RANGE*bs;
+  len[7] = sizeof(msg);
+  elephant_setkey(&dk, key, variant);
+  for (i = 0; i < (int) sizeof(msg); i++) msg[i] = (UChar) (3*i + 1);
+  for (i = 0; i < 8; i++) {
+    for (alen = 0; alen <= 48; alen += 8) {
+      elephant_aead_encrypt(ct1, tag, msg, len[i], ad, alen, npub, key,
+        variant);
+      elephant_aead_encrypt_dk(ct2, tag2, msg, len[i], ad, alen, npub, &dk);
+      if (memcmp(ct1, ct2, len[i]) != 0 || memcmp(tag, tag2, ts) != 0) {
+        err++;
+      }
+      res = elephant_aead_decrypt_par(ct2, ct2, len[i], tag2, ad, alen, npub,
+        key, variant);
+      if (res != 0 || memcmp(ct2, msg, len[i]) != 0) err++;
+    }
+  }
+  printf("Mismatches: %i\n", err);
+
+  // 5th test: jump-ahead of the mask LFSR versus stepping (including jumps
+  // beyond the cached table and beyond 2^ELEPHANT_JUMPBITS blocks)
+
+  printf("Test 5 - Jump-ahead of the mask LFSR:\n");
+  err = 0;
+  memcpy(x, dk.ek, bs);
+  for (n = 0, i = 0; i < 6; i++) {
+    for (; n < jmp[i]; n++) PARAMS[variant].lfsr(x, x);
+    elephant_jump(y, dk.ek, jmp[i], variant);
+    if (memcmp(x, y, bs) != 0) err++;
+  }
+  elephant_extend(&dk, ELEPHANT_MAXRANGES);
+  for (n = 64; n < 70; n++) {
+    elephant_range_mask(x, &dk, n << ELEPHANT_RANGEBITS);
+    elephant_jump(y, dk.ek, n << ELEPHANT_RANGEBITS, variant);
+    if (memcmp(x, y, bs) != 0) err++;
+  }
+  n = ((size_t) 3 << ELEPHANT_JUMPBITS) + 12345;
+  elephant_jump(x, dk.ek, n, variant);
+  elephant_jump(y, dk.ek, n/2, variant);
+  elephant_jump(y, y, n - n/2, variant);
+  if (memcmp(x, y, bs) != 0) err++;
+  printf("Mismatches: %i\n", err);
+#endif
+
+  // Expected result for Dumbo
+  // -------------------------
+  // Test 1 - C99 implementation:
+  // Tag: 6655b717736adff3
+  // Test 2 - C99 implementation:
+  // CT:  0867290ad29d219c4bf3bf0bd652099b499b5b9cd7401b7ecfe8b7d30f5e05bdf4d27fac07819cb232
+  // Tag: dd883027a4888513
+  // PT:  000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728
+  // Verification: ok
+  // Test 3 - C99 implementation:
+  // Verification: failed
+  // CT:  0867290ad29d219c4bf3bf0bd652099b499b5b9cd7401b7ecfe8b7d30f5e05bdf4d27fac07819cb233
+  // Test 4 - C99 parallel implementation:
+  // Mismatches: 0
+  // Test 5 - Jump-ahead of the mask LFSR:
+  // Mismatches: 0
+
+  // Expected result for Jumbo
+  // -------------------------
+  // Test 1 - C99 implementation:
+  // Tag: 1407ef22639e4ae1
+  // Test 2 - C99 implementation:
+  // CT:  ae5d4f2bfae6d432a1b6e92eb8955a7f2fd61692b269cd725e51aada102ec84283e1b9f5d2bc1f8bc2
+  // Tag: db7667c95497c098
+  // PT:  000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728
+  // Verification: ok
+  // Test 3 - C99 implementation:
+  // Verification: failed
+  // CT:  ae5d4f2bfae6d432a1b6e92eb8955a7f2fd61692b269cd725e51aada102ec84283e1b9f5d2bc1f8bc3
+  // Test 4 - C99 parallel implementation:
+  // Mismatches: 0
+  // Test 5 - Jump-ahead of the mask LFSR:
+  // Mismatches: 0
+
+  // Expected result for Delirium
+  // ----------------------------
+  // Test 1 - C99 implementation:
+  // Tag: 48bf257607d09ebe1c0e108b91058877
+  // Test 2 - C99 implementation:
+  // CT:  1ebbe29d3ec4d574840905efcebfb40d02e1ab1b8b99947a48fe7694312af730d3ff78305a919c84e6
+  // Tag: 12ff60a5029ac604625b37e31336e443
+  // PT:  000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728
+  // Verification: ok
+  // Test 3 - C99 implementation:
+  // Verification: failed
+  // CT:  1ebbe29d3ec4d574840905efcebfb40d02e1ab1b8b99947a48fe7694312af730d3ff78305a919c84e7
+  // Test 4 - C99 parallel implementation:
+  // Mismatches: 0
+  // Test 5 - Jump-ahead of the mask LFSR:
+  // Mismatches: 0
+}
+
+
+// Benchmark of the three variants. Messages of different lengths (without
+// associated data) are encrypted `iter` times with Dumbo, Jumbo, and
+// Delirium; the printed values are the number of CYCLES() ticks per
+// encryption times 1000. On the MSP430, the variants use the Assembler
+// permutations, i.e. the values can be compared directly.
+
+void elephant_bench_aead(long iter)
+{
+  static const size_t len[4] = { 16, 64, 256, 1024 };
+  static UChar buf[1024];
+  UChar key[16], npub[NPUBSZ], tag[MAXTAG];
+  unsigned long start, t[3];
+  long n;
+  int i, v;
+
+  for (i = 0; i < 16; i++) key[i] = (UChar) i;
+  for (i = 0; i < NPUBSZ; i++) npub[i] = (UChar) i;
+  for (i = 0; i < 1024; i++) buf[i] = (UChar) i;
+
+  for (i = 0; i < 4; i++) {
+    for (v = DUMBO; v <= DELIRIUM; v++) {
+      start = CYCLES();
+      for (n = 0; n < iter; n++) {
+        elephant_aead_encrypt(buf, tag, buf, len[i], NULL, 0, npub, key, v);
+      }
+      t[v] = CYCLES() - start;
+    }
+    printf("%4i bytes: Dumbo %llu, Jumbo %llu, Delirium %llu\n",
+      (int) len[i], TICKS1000(t[0], iter), TICKS1000(t[1], iter),
+      TICKS1000(t[2], iter));
+  }
+}
+
+
+#if !defined(SPONGENT_ASSEMBLER)
+
+// Benchmark of the parallel path. A message of `len` bytes (without
+// associated data) is encrypted `iter` times with the sequential and the
+// parallel version; the printed values are the number of CYCLES() ticks per
+// encryption times 1000 and the ratio of the two in %. Note that clock()
+// measures the processor time of all threads, i.e. CYCLES() has to be
+// re-defined to read a wall-clock counter (e.g. __rdtsc) to see the speed-up
+// of the worker threads.
+
+void elephant_bench_par(int variant, size_t len, long iter)
+{
+  static UChar buf[1 << 22];
+  UChar key[16], npub[NPUBSZ], tag[MAXTAG];
+  unsigned long start, t_seq, t_par;
+  size_t i;
+  long n;
+
+  len = MIN(len, sizeof(buf));
+  for (i = 0; i < 16; i++) key[i] = (UChar) i;
+  for (i = 0; i < NPUBSZ; i++) npub[i] = (UChar) i;
+  for (i = 0; i < len; i++) buf[i] = (UChar) i;
+
+  start = CYCLES();
+  for (n = 0; n < iter; n++) {
+    elephant_aead_encrypt(buf, tag, buf, len, NULL, 0, npub, key, variant);
+  }
+  t_seq = CYCLES() - start;
+  start = CYCLES();
+  for (n = 0; n < iter; n++) {
+    elephant_aead_encrypt_par(buf, tag, buf, len, NULL, 0, npub, key,
+      variant);
+  }
+  t_par = CYCLES() - start;
+  printf("%7i bytes: sequential %llu, parallel %llu (%llu%%)\n", (int) len,
+    TICKS1000(t_seq, iter), TICKS1000(t_par, iter), PERCENT(t_par, t_seq));
+}
+
+
+// Benchmark of the mask generation. The printed values are the number of
+// CYCLES() ticks times 1000 for one step of the LFSR (i.e. the cost per
+// block of the incremental masks), a jump-ahead over 2^20-1 blocks (the
+// worst case for 20 bits), the set-up of a key context (expansion of the
+// key), the computation of the complete table of start masks (which is only
+// done once per key), and one permutation for comparison.
+
+void elephant_bench_mask(int variant, long iter)
+{
+  const ElephantParams *p = &PARAMS[variant];
+  UChar key[16], x[MAXBLK];
+  unsigned long start, stop;
+  ElephantKey dk;
+  long n;
+  int i;
+
+  for (i = 0; i < 16; i++) key[i] = (UChar) i;
+  elephant_setkey(&dk, key, variant);
+  memcpy(x, dk.ek, p->bs);
+
+  start = CYCLES();
+  for (n = 0; n < iter; n++) p->lfsr(x, x);
+  stop = CYCLES();
+  printf("LFSR step  : %llu (%02x)\n", TICKS1000(stop - start, iter), x[0]);
+
+  start = CYCLES();
+  for (n = 0; n < iter; n++) elephant_jump(x, x, 0xfffff, variant);
+  stop = CYCLES();
+  printf("Jump-ahead : %llu (%02x)\n", TICKS1000(stop - start, iter), x[0]);
+
+  start = CYCLES();
+  for (n = 0; n < iter; n++) elephant_setkey(&dk, x, variant);
+  stop = CYCLES();
+  printf("Key context: %llu (%02x)\n", TICKS1000(stop - start, iter),
+    dk.ek[0]);
+
+  start = CYCLES();
+  for (n = 0; n < iter; n++) {
+    dk.nrm = 1;
+    elephant_extend(&dk, ELEPHANT_MAXRANGES);
+  }
+  stop = CYCLES();
+  printf("Mask table : %llu (%02x)\n", TICKS1000(stop - start, iter),
+    dk.rmask[ELEPHANT_MAXRANGES-1][0]);
+
+  start = CYCLES();
+  for (n = 0; n < iter; n++) p->perm(x);
+  stop = CYCLES();
+  printf("Permutation: %llu (%02x)\n", TICKS1000(stop - start, iter), x[0]);
+}
+
+#endif  // !defined(SPONGENT_ASSEMBLER)
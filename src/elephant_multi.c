@@ -0,0 +1,398 @@
+///////////////////////////////////////////////////////////////////////////////
+// elephant_multi.c: Bitsliced multi-state Spongent-pi[160] and unit-test.   //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+
+// maximum number of states of the bitsliced kernels (one bit of a 64-bit
+// slice per state)
+#define BS_MAXSTATES 64
+
+// smallest number of states for which permutation_C99_bs uses a bitsliced
+// kernel (smaller batches are permuted with permutation_C99_xN)
+#if !defined(BS_MINSTATES)
+#if defined(__AVX2__)
+#define BS_MINSTATES 3
+#else
+#define BS_MINSTATES 8
+#endif
+#endif
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` times 1000 divided by `n`; the result is a
+// ULLInt since 1000*t exceeds 32 bits on MSP430 after 4.29M ticks
+#define TICKS1000(t, n) ((1000*(ULLInt) (t))/(n))
+
+
+extern void permutation_C99(uint8_t* state);
+extern void permutation_C99_xN(uint8_t* states, int n);
+
+
+// In the bitsliced representation, the 160 bits of up to 64 states are kept
+// in 160 slices of 64 bits each: bit l of slice b is bit b of state l (i.e.
+// bit b%8 of byte b/8). The pLayer, which moves bit 4k+r to position 40r+k,
+// is then merely a renaming of the slices, and the S-box is evaluated for 64
+// nibbles at once with the Boolean circuit below. The lCounter is added
+// branch-free by XORing a 0 or all-1 word to the slices 0-6 and 153-159.
+//
+// The circuit is derived from the algebraic normal form of the S-box (bit 0
+// is the LSB of a nibble); it needs 19 operations including three NOTs:
+// y0 = x0 ^ x1x2 ^ x1 ^ x3
+// y1 = ~(x3 ? x1 ^ x2 : x0 ^ x1x2)
+// y2 = ~(x1 ^ x2 ^ (x0 ^ x1x2)x3)
+// y3 = ~(x0x1 ^ x2 ^ x3(x0 ? x2 : ~x1))
+
+#define SBOX64(y0, y1, y2, y3, x0, x1, x2, x3) do { \
+  uint64_t t_, u_, w_, z_; \
+  u_ = (x0) ^ ((x1) & (x2)); \
+  t_ = (x1) ^ (x2); \
+  (y0) = u_ ^ (x1) ^ (x3); \
+  (y1) = ~(u_ ^ ((u_ ^ t_) & (x3))); \
+  (y2) = ~(t_ ^ (u_ & (x3))); \
+  w_ = ((x0) & (x1)) ^ (x2); \
+  z_ = (x1) ^ ((x0) & ~t_); \
+  (y3) = ~(w_ ^ ((x3) & ~z_)); \
+} while (0)
+
+
+// Transpose of an 8x8 bit-matrix stored row by row in a 64-bit word, i.e.
+// bit 8r+c is swapped with bit 8c+r (three delta swaps).
+
+static uint64_t transpose8x8(uint64_t x)
+{
+  uint64_t t;
+
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  x ^= t ^ (t << 28);
+
+  return x;
+}
+
+
+// Conversion of `n` <= 64 states (20 bytes each, stored one after the other)
+// to 160 slices and back. Byte i of eight states forms an 8x8 bit-matrix
+// whose transpose contains the bits 8i to 8i+7 of these states. The slice
+// bits of the missing states (if `n` < 64) are set to 0 and ignored.
+
+static void bs_load(uint64_t *slice, const uint8_t *states, int n)
+{
+  uint64_t x;
+  int g, i, j, r;
+
+  memset(slice, 0, 160*sizeof(uint64_t));
+  for (g = 0; 8*g < n; g++) {
+    for (i = 0; i < 20; i++) {
+      x = 0;
+      for (r = 0; r < MIN(8, n - 8*g); r++)
+        x |= ((uint64_t) states[20*(8*g+r)+i]) << 8*r;
+      x = transpose8x8(x);
+      for (j = 0; j < 8; j++) slice[8*i+j] |= ((x >> 8*j) & 0xff) << 8*g;
+    }
+  }
+}
+
+static void bs_store(uint8_t *states, const uint64_t *slice, int n)
+{
+  uint64_t x;
+  int g, i, j, r;
+
+  for (g = 0; 8*g < n; g++) {
+    for (i = 0; i < 20; i++) {
+      x = 0;
+      for (j = 0; j < 8; j++) x |= ((slice[8*i+j] >> 8*g) & 0xff) << 8*j;
+      x = transpose8x8(x);
+      for (r = 0; r < MIN(8, n - 8*g); r++)
+        states[20*(8*g+r)+i] = (uint8_t) (x >> 8*r);
+    }
+  }
+}
+
+
+// Portable 64-bit version: permutes `n` <= 64 states with 64-bit slices. The
+// S-box layer reads the slices from `s` and writes them (in pLayer order) to
+// `t`, after which the two buffers swap their roles.
+
+void spongent_bs64(uint8_t *states, int n)
+{
+  uint64_t buf[2][160], *s = buf[0], *t = buf[1], *u, m;
+  uint8_t IV = 0x75;
+  int i, j, k;
+
+  bs_load(s, states, n);
+
+  for (i = 0; i < 80; i++) {
+    // Add IVs
+    for (j = 0; j < 7; j++) {
+      m = -(uint64_t) ((IV >> j) & 1);
+      s[j] ^= m;
+      s[159-j] ^= m;
+    }
+    // L-counter
+    IV = ((IV << 1) | (((IV >> 6) ^ (IV >> 5)) & 1)) & 0x7f;
+    // S-box and P-layer
+    for (k = 0; k < 40; k++)
+      SBOX64(t[k], t[40+k], t[80+k], t[120+k], s[4*k], s[4*k+1], s[4*k+2],
+        s[4*k+3]);
+    u = s; s = t; t = u;
+  }
+
+  bs_store(states, s, n);
+}
+
+
+#if defined(__AVX2__)
+
+// The AVX2 version evaluates the S-boxes of the four nibbles k, k+10, k+20,
+// and k+30 in the four 64-bit lanes of a vector. Therefore, the slices are
+// kept in 40 vectors w[q] whose lane j contains slice 40j+q, i.e. the input
+// bit b of the four nibbles with index k+10j is w[4k+b]. The output bit r of
+// nibble k+10j goes to slice 40r+k+10j, which is lane r of vector k+10j. A
+// 4x4 transpose of the four output vectors of a group thus yields the four
+// new vectors k, k+10, k+20, and k+30.
+
+#define SBOX256(y0, y1, y2, y3, x0, x1, x2, x3) do { \
+  __m256i t_, u_, w_, z_; \
+  u_ = _mm256_xor_si256((x0), _mm256_and_si256((x1), (x2))); \
+  t_ = _mm256_xor_si256((x1), (x2)); \
+  (y0) = _mm256_xor_si256(_mm256_xor_si256(u_, (x1)), (x3)); \
+  (y1) = _mm256_xor_si256(_mm256_and_si256(_mm256_xor_si256(u_, t_), (x3)), \
+    u_); \
+  (y1) = _mm256_xor_si256((y1), ones); \
+  (y2) = _mm256_xor_si256(_mm256_and_si256(u_, (x3)), t_); \
+  (y2) = _mm256_xor_si256((y2), ones); \
+  w_ = _mm256_xor_si256(_mm256_and_si256((x0), (x1)), (x2)); \
+  z_ = _mm256_xor_si256(_mm256_andnot_si256(t_, (x0)), (x1)); \
+  (y3) = _mm256_xor_si256(_mm256_andnot_si256(z_, (x3)), w_); \
+  (y3) = _mm256_xor_si256((y3), ones); \
+} while (0)
+
+// 4x4 transpose of 64-bit elements
+#define TRANSPOSE4X4(x0, x1, x2, x3) do { \
+  __m256i a_, b_, c_, d_; \
+  a_ = _mm256_unpacklo_epi64((x0), (x1)); \
+  b_ = _mm256_unpackhi_epi64((x0), (x1)); \
+  c_ = _mm256_unpacklo_epi64((x2), (x3)); \
+  d_ = _mm256_unpackhi_epi64((x2), (x3)); \
+  (x0) = _mm256_permute2x128_si256(a_, c_, 0x20); \
+  (x1) = _mm256_permute2x128_si256(b_, d_, 0x20); \
+  (x2) = _mm256_permute2x128_si256(a_, c_, 0x31); \
+  (x3) = _mm256_permute2x128_si256(b_, d_, 0x31); \
+} while (0)
+
+void spongent_bs_avx2(uint8_t *states, int n)
+{
+  uint64_t slice[160], lane[40][4];
+  __m256i buf[2][40], *s = buf[0], *t = buf[1], *u;
+  __m256i ones = _mm256_set1_epi64x(-1), y0, y1, y2, y3;
+  uint8_t IV = 0x75;
+  int i, j, k;
+
+  bs_load(slice, states, n);
+  for (k = 0; k < 40; k++) {
+    s[k] = _mm256_set_epi64x((long long) slice[120+k],
+      (long long) slice[80+k], (long long) slice[40+k], (long long) slice[k]);
+  }
+
+  for (i = 0; i < 80; i++) {
+    // Add IVs (slices 0-6 are in lane 0, slices 153-159 in lane 3)
+    for (j = 0; j < 7; j++) {
+      y0 = _mm256_set1_epi64x(-(long long) ((IV >> j) & 1));
+      s[j] = _mm256_xor_si256(s[j], _mm256_blend_epi32(_mm256_setzero_si256(),
+        y0, 0x03));
+      s[39-j] = _mm256_xor_si256(s[39-j],
+        _mm256_blend_epi32(_mm256_setzero_si256(), y0, 0xc0));
+    }
+    // L-counter
+    IV = ((IV << 1) | (((IV >> 6) ^ (IV >> 5)) & 1)) & 0x7f;
+    // S-box and P-layer
+    for (k = 0; k < 10; k++) {
+      SBOX256(y0, y1, y2, y3, s[4*k], s[4*k+1], s[4*k+2], s[4*k+3]);
+      TRANSPOSE4X4(y0, y1, y2, y3);
+      t[k] = y0; t[k+10] = y1; t[k+20] = y2; t[k+30] = y3;
+    }
+    u = s; s = t; t = u;
+  }
+
+  for (k = 0; k < 40; k++) {
+    _mm256_storeu_si256((__m256i *) lane[k], s[k]);
+    for (j = 0; j < 4; j++) slice[40*j+k] = lane[k][j];
+  }
+  bs_store(states, slice, n);
+}
+
+#endif  // defined(__AVX2__)
+
+
+// Batched permutation of an arbitrary number of states (20 bytes each, one
+// after the other): groups of up to 64 states are processed with the AVX2
+// or the portable bitsliced kernel (depending on whether AVX2 is enabled at
+// compile time), a remainder of less than BS_MINSTATES states with the
+// interleaved table-based permutation_C99_xN. The result is identical to `n`
+// calls of permutation_C99.
+
+void permutation_C99_bs(uint8_t *states, int n)
+{
+  int m;
+
+  while (n >= BS_MINSTATES) {
+    m = MIN(n, BS_MAXSTATES);
+#if defined(__AVX2__)
+    spongent_bs_avx2(states, m);
+#else
+    spongent_bs64(states, m);
+#endif
+    states += 20*m;
+    n -= m;
+  }
+  if (n > 0) permutation_C99_xN(states, n);
+}
+
+
+// Print the 20 bytes of the state of Spongent-pi[160] in Hex format.
+
+static void print_state(const uint8_t *state)
+{
+  int i;
+
+  for (i = 0; i < 20; i++) printf("%02x", state[i]);
+  printf("\n");
+}
+
+
+// Fill `n` states with pseudo-random bytes (always the same sequence).
+
+static void fill_states(uint8_t *states, int n)
+{
+  uint8_t x = 0x5a;
+  int i;
+
+  for (i = 0; i < 20*n; i++) {
+    x = (uint8_t) (181*x + 1);
+    states[i] = x;
+  }
+}
+
+
+// Simple test function for the bitsliced Spongent-pi[160] permutation. A
+// batch of 75 states (i.e. one group of 64 and a remainder of 11) is filled
+// with pseudo-random bytes and permuted with permutation_C99_bs, and batches
+// of 1, 8, 33, and 64 states with the kernels directly. All states are
+// compared with permutation_C99 and the first and last state are printed.
+
+void spongent_test_multi(void)
+{
+  static uint8_t s[75*20], t[75*20];
+  int size[4] = { 1, 8, 33, 64 };
+  int i, j, errors = 0;
+
+  fill_states(t, 75);
+  for (j = 0; j < 75; j++) permutation_C99(t + 20*j);
+
+  printf("Test 1 - Batch of 75 states:\n");
+  fill_states(s, 75);
+  permutation_C99_bs(s, 75);
+  print_state(s);
+  print_state(s + 74*20);
+  for (j = 0; j < 75; j++) errors += (memcmp(s + 20*j, t + 20*j, 20) != 0);
+  printf("States differing from permutation_C99: %i\n", errors);
+
+  printf("Test 2 - Kernels with 1, 8, 33, and 64 states:\n");
+  errors = 0;
+  for (i = 0; i < 4; i++) {
+    fill_states(s, size[i]);
+    spongent_bs64(s, size[i]);
+    for (j = 0; j < size[i]; j++)
+      errors += (memcmp(s + 20*j, t + 20*j, 20) != 0);
+#if defined(__AVX2__)
+    fill_states(s, size[i]);
+    spongent_bs_avx2(s, size[i]);
+    for (j = 0; j < size[i]; j++)
+      errors += (memcmp(s + 20*j, t + 20*j, 20) != 0);
+#endif
+  }
+  printf("States differing from permutation_C99: %i\n", errors);
+
+  // Expected result
+  // ---------------
+  // Test 1 - Batch of 75 states:
+  // cedeef355513fe823f5d01c344b3d114c5f22933
+  // 2bf81ca0d0ddc839225922e01545fa3a4827bfe3
+  // States differing from permutation_C99: 0
+  // Test 2 - Kernels with 1, 8, 33, and 64 states:
+  // States differing from permutation_C99: 0
+}
+
+
+// Simple benchmark function for batches of 8, 16, 32, and 64 states. The
+// printed figures are the number of CYCLES() ticks per state times 1000 and
+// the first byte of the result (to prevent the compiler from optimizing the
+// loops away).
+
+void spongent_bench_multi(long iter)
+{
+  static uint8_t s[64*20];
+  int size[4] = { 8, 16, 32, 64 };
+  unsigned long start, stop;
+  long n;
+  int i;
+
+  memset(s, 0, sizeof(s));
+  for (i = 0; i < 4; i++) {
+    printf("Batch of %i states:\n", size[i]);
+    start = CYCLES();
+    for (n = 0; n < iter; n++) permutation_C99_xN(s, size[i]);
+    stop = CYCLES();
+    printf("permutation_C99_xN: %llu (%02X)\n",
+      TICKS1000(stop - start, (ULLInt) iter*size[i]), s[0]);
+    start = CYCLES();
+    for (n = 0; n < iter; n++) spongent_bs64(s, size[i]);
+    stop = CYCLES();
+    printf("spongent_bs64     : %llu (%02X)\n",
+      TICKS1000(stop - start, (ULLInt) iter*size[i]), s[0]);
+#if defined(__AVX2__)
+    start = CYCLES();
+    for (n = 0; n < iter; n++) spongent_bs_avx2(s, size[i]);
+    stop = CYCLES();
+    printf("spongent_bs_avx2  : %llu (%02X)\n",
+      TICKS1000(stop - start, (ULLInt) iter*size[i]), s[0]);
+#endif
+  }
+}
@@ -5,6 +5,17 @@
 #include <stdio.h>
 #include <string.h>
 
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` times 1000 divided by `n`; the result is an
+// unsigned long long since 1000*t exceeds 32 bits on MSP430 after 4.29M ticks
+#define TICKS1000(t, n) ((1000*(unsigned long long) (t))/(n))
+
 
 
 // ====================== Version 1: Ref (160v2)
@@ -55,6 +66,14 @@ void print_state(uint8_t* state)
 }
 
 
+void print_state176(uint8_t* state)
+{
+	for(int i = 21; i>=0; i--)
+		printf(" %02X", state[i]);
+	printf("\n");
+}
+
+
 
 void permutation_C99(uint8_t* state)
 {
@@ -107,7 +126,128 @@ void permutation_C99(uint8_t* state)
 
 
 
-// ====================== Version 2: Optimized Assembler Version
+// ====================== Version 2: Optimized C99 Version
+
+
+// The pLayer of Spongent-pi[160] moves bit n = 4k+r of the state to position
+// 40r+k, i.e. it collects bit r of all 40 nibbles in the r-th quarter of the
+// state. Output byte 5r+m thus consists of bit r and bit r+4 of the input
+// bytes 4m to 4m+3. The table below combines the S-box with an "unshuffle"
+// of the result that places bit r and bit r+4 into the 2-bit field r of a
+// byte; a 4x4 transpose of the 2-bit fields of four such bytes (two delta
+// swaps on a 32-bit word) then yields four complete output bytes.
+
+static const uint8_t sp_box[256] = {
+    0xfc, 0xf9, 0xed, 0xa8, 0xac, 0xa9, 0xb8, 0xfd,
+    0xbd, 0xec, 0xe8, 0xb9, 0xe9, 0xf8, 0xad, 0xbc,
+    0xf6, 0xf3, 0xe7, 0xa2, 0xa6, 0xa3, 0xb2, 0xf7,
+    0xb7, 0xe6, 0xe2, 0xb3, 0xe3, 0xf2, 0xa7, 0xb6,
+    0xde, 0xdb, 0xcf, 0x8a, 0x8e, 0x8b, 0x9a, 0xdf,
+    0x9f, 0xce, 0xca, 0x9b, 0xcb, 0xda, 0x8f, 0x9e,
+    0x54, 0x51, 0x45, 0x00, 0x04, 0x01, 0x10, 0x55,
+    0x15, 0x44, 0x40, 0x11, 0x41, 0x50, 0x05, 0x14,
+    0x5c, 0x59, 0x4d, 0x08, 0x0c, 0x09, 0x18, 0x5d,
+    0x1d, 0x4c, 0x48, 0x19, 0x49, 0x58, 0x0d, 0x1c,
+    0x56, 0x53, 0x47, 0x02, 0x06, 0x03, 0x12, 0x57,
+    0x17, 0x46, 0x42, 0x13, 0x43, 0x52, 0x07, 0x16,
+    0x74, 0x71, 0x65, 0x20, 0x24, 0x21, 0x30, 0x75,
+    0x35, 0x64, 0x60, 0x31, 0x61, 0x70, 0x25, 0x34,
+    0xfe, 0xfb, 0xef, 0xaa, 0xae, 0xab, 0xba, 0xff,
+    0xbf, 0xee, 0xea, 0xbb, 0xeb, 0xfa, 0xaf, 0xbe,
+    0x7e, 0x7b, 0x6f, 0x2a, 0x2e, 0x2b, 0x3a, 0x7f,
+    0x3f, 0x6e, 0x6a, 0x3b, 0x6b, 0x7a, 0x2f, 0x3e,
+    0xdc, 0xd9, 0xcd, 0x88, 0x8c, 0x89, 0x98, 0xdd,
+    0x9d, 0xcc, 0xc8, 0x99, 0xc9, 0xd8, 0x8d, 0x9c,
+    0xd4, 0xd1, 0xc5, 0x80, 0x84, 0x81, 0x90, 0xd5,
+    0x95, 0xc4, 0xc0, 0x91, 0xc1, 0xd0, 0x85, 0x94,
+    0x76, 0x73, 0x67, 0x22, 0x26, 0x23, 0x32, 0x77,
+    0x37, 0x66, 0x62, 0x33, 0x63, 0x72, 0x27, 0x36,
+    0xd6, 0xd3, 0xc7, 0x82, 0x86, 0x83, 0x92, 0xd7,
+    0x97, 0xc6, 0xc2, 0x93, 0xc3, 0xd2, 0x87, 0x96,
+    0xf4, 0xf1, 0xe5, 0xa0, 0xa4, 0xa1, 0xb0, 0xf5,
+    0xb5, 0xe4, 0xe0, 0xb1, 0xe1, 0xf0, 0xa5, 0xb4,
+    0x5e, 0x5b, 0x4f, 0x0a, 0x0e, 0x0b, 0x1a, 0x5f,
+    0x1f, 0x4e, 0x4a, 0x1b, 0x4b, 0x5a, 0x0f, 0x1e,
+    0x7c, 0x79, 0x6d, 0x28, 0x2c, 0x29, 0x38, 0x7d,
+    0x3d, 0x6c, 0x68, 0x39, 0x69, 0x78, 0x2d, 0x3c
+};
+
+// bit-reversal of a nibble (for the inverted lCounter)
+static const uint8_t rev4[16] = {
+    0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe,
+    0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf
+};
+
+
+// One round of Spongent-pi[160] with the lCounter value `IV`.
+
+static void sp_round(uint8_t* state, uint8_t IV)
+{
+    uint8_t tmp[20];
+    uint32_t w, t;
+    int m;
+
+    // Add IVs
+    state[0] ^= IV;
+    state[19] ^= (rev4[IV & 0xf] << 4) | rev4[IV >> 4];
+
+    // S-box and P-layer, four input bytes at a time
+    for (m = 0; m < 5; m++)
+    {
+        w = (uint32_t) sp_box[state[4*m]] |
+            ((uint32_t) sp_box[state[4*m+1]] << 8) |
+            ((uint32_t) sp_box[state[4*m+2]] << 16) |
+            ((uint32_t) sp_box[state[4*m+3]] << 24);
+        t = ((w >> 6) ^ w) & 0x00cc00ccUL;
+        w ^= t ^ (t << 6);
+        t = ((w >> 12) ^ w) & 0x0000f0f0UL;
+        w ^= t ^ (t << 12);
+        tmp[m]    = (uint8_t) w;
+        tmp[m+5]  = (uint8_t) (w >> 8);
+        tmp[m+10] = (uint8_t) (w >> 16);
+        tmp[m+15] = (uint8_t) (w >> 24);
+    }
+    memcpy(state, tmp, 20);
+}
+
+
+void permutation_C99_V2(uint8_t* state)
+{
+    uint8_t IV = 0x75;
+    int i;
+
+    for (i = 0; i < 80; i++)
+    {
+        sp_round(state, IV);
+        // L-counter
+        IV = ((IV << 1) | (((IV >> 6) ^ (IV >> 5)) & 1)) & 0x7f;
+    }
+}
+
+
+// Permutation of `n` independent states that are stored one after the other
+// in `states` (20 bytes each). The rounds are interleaved, i.e. round i is
+// applied to all states before round i+1, so that the lookups of different
+// states can overlap. The result is identical to `n` calls of
+// permutation_C99_V2.
+
+void permutation_C99_xN(uint8_t* states, int n)
+{
+    uint8_t IV = 0x75;
+    int i, j;
+
+    for (i = 0; i < 80; i++)
+    {
+        for (j = 0; j < n; j++)
+            sp_round(states + 20*j, IV);
+        // L-counter
+        IV = ((IV << 1) | (((IV >> 6) ^ (IV >> 5)) & 1)) & 0x7f;
+    }
+}
+
+
+
+// ====================== Version 3: Optimized Assembler Version
 
 
 
@@ -118,6 +258,144 @@ extern void spongent_msp(uint8_t s[20]);
 
 
 
+// ====================== Version 4: Spongent-pi[176] (Jumbo)
+
+
+// Spongent-pi[176] has a state of 22 bytes and 90 rounds, and its lCounter
+// starts with 0x45. The reference version below is the same as Version 1
+// except for these parameters, i.e. its pLayer moves bit j to position
+// 44*j mod 175 (and bit 175 stays in place).
+
+void permutation176_C99(uint8_t* state)
+{
+    uint8_t IV = 0x45;
+    uint8_t INV_IV;
+    int     pb;
+    uint8_t tmp[22], x, y;
+
+    for(int i = 0; i < 90; i++)
+    {
+        // Add IVs
+        state[0] ^= IV;
+        INV_IV = (rev4[IV & 0xf] << 4) | rev4[IV >> 4];
+        state[21] ^= INV_IV;
+
+        // L-counter
+        IV = (IV << 1) | (((IV & 0x40) >> 6) ^ ((IV & 0x20) >> 5));
+        IV &= 0x7f;
+
+        // S-box
+        for(int j = 0; j < 22; j++)
+            state[j] =  s_box[state[j]];
+
+        // P-layer
+        for(int i = 0; i < 22; i++)
+            tmp[i] = 0;
+
+        for(int i = 0; i < 22; i++)
+        {
+            for(int j = 0; j < 8; j++)
+            {
+                x = (state[i] >> j) & 0x1;
+                if (8*i+j != 175)
+                    pb = ((8*i+j)*44)%175;
+                else
+                    pb = 175;
+                y            = pb/8;
+                tmp[y] ^= x << (pb - 8*y);
+            }
+        }
+        memcpy(state, tmp, 22);
+    }
+}
+
+
+// In the optimized version, the pLayer collects bit r of the 44 nibbles in
+// the r-th quarter of 44 bits, i.e. quarter r starts at bit 44r, which is
+// not byte-aligned for r = 1 and r = 3. The four quarters are assembled in
+// 64-bit words: the transpose of Version 2 yields 8 bits of each quarter
+// per four input bytes, and the quarters are then shifted into place.
+
+static void sp176_round(uint8_t* state, uint8_t IV)
+{
+    uint64_t q0 = 0, q1 = 0, q2 = 0, q3 = 0, lo, mid, hi;
+    uint32_t w, t;
+    int m;
+
+    // Add IVs
+    state[0] ^= IV;
+    state[21] ^= (rev4[IV & 0xf] << 4) | rev4[IV >> 4];
+
+    // S-box and P-layer, four input bytes at a time (two in the last step,
+    // which thus contributes only 4 bits to each quarter)
+    for (m = 0; m < 6; m++)
+    {
+        w = (uint32_t) sp_box[state[4*m]] |
+            ((uint32_t) sp_box[state[4*m+1]] << 8);
+        if (m < 5)
+            w |= ((uint32_t) sp_box[state[4*m+2]] << 16) |
+                 ((uint32_t) sp_box[state[4*m+3]] << 24);
+        t = ((w >> 6) ^ w) & 0x00cc00ccUL;
+        w ^= t ^ (t << 6);
+        t = ((w >> 12) ^ w) & 0x0000f0f0UL;
+        w ^= t ^ (t << 12);
+        q0 |= ((uint64_t) (w & 0xff)) << (8*m);
+        q1 |= ((uint64_t) ((w >> 8) & 0xff)) << (8*m);
+        q2 |= ((uint64_t) ((w >> 16) & 0xff)) << (8*m);
+        q3 |= ((uint64_t) (w >> 24)) << (8*m);
+    }
+
+    lo  = q0 | (q1 << 44);
+    mid = (q1 >> 20) | (q2 << 24);
+    hi  = (q2 >> 40) | (q3 << 4);
+    for (m = 0; m < 8; m++)
+    {
+        state[m]   = (uint8_t) (lo >> (8*m));
+        state[m+8] = (uint8_t) (mid >> (8*m));
+    }
+    for (m = 0; m < 6; m++)
+        state[m+16] = (uint8_t) (hi >> (8*m));
+}
+
+
+void permutation176_C99_V2(uint8_t* state)
+{
+    uint8_t IV = 0x45;
+    int i;
+
+    for (i = 0; i < 90; i++)
+    {
+        sp176_round(state, IV);
+        // L-counter
+        IV = ((IV << 1) | (((IV >> 6) ^ (IV >> 5)) & 1)) & 0x7f;
+    }
+}
+
+
+// Permutation of `n` independent 22-byte states with interleaved rounds
+// (see permutation_C99_xN).
+
+void permutation176_C99_xN(uint8_t* states, int n)
+{
+    uint8_t IV = 0x45;
+    int i, j;
+
+    for (i = 0; i < 90; i++)
+    {
+        for (j = 0; j < n; j++)
+            sp176_round(states + 22*j, IV);
+        // L-counter
+        IV = ((IV << 1) | (((IV >> 6) ^ (IV >> 5)) & 1)) & 0x7f;
+    }
+}
+
+
+#if (defined(__MSP430__) || defined(__ICC430__))
+extern void spongent176_msp(uint8_t s[22]);
+#endif
+
+
+
 // ====================== Test Function
 
 
@@ -133,19 +411,108 @@ void spongent_test_perm()
     print_state(s);
     permutation_C99(s);  // measurement: 5620386 cycles
     print_state(s);
+
+    // 2nd test
+    printf("Test 2 - Optimized C99 implementation:\n");
+    for (i=0 ; i<20 ; i++) s[i]=i;
+    print_state(s);
+    permutation_C99_V2(s);
+    print_state(s);
     
 
 #if defined(SPONGENT_ASSEMBLER)
-    // 2nd test
-    printf("Output Test 2 - Assembler implementation:\n");
+    // 3rd test
+    printf("Output Test 3 - Assembler implementation:\n");
     for (i=0 ; i<20 ; i++) s[i]=i;
     print_state(s);
     spongent_msp(s); // measurement: 40495 cycles
     print_state(s);
 #endif   
+
+    // Expected result
+    // ---------------
+    // Test 1 - C99 implementation:
+    //  13 12 11 10 0F 0E 0D 0C 0B 0A 09 08 07 06 05 04 03 02 01 00
+    //  7B F7 7B 26 73 7D 2C 26 A2 F1 19 CC F7 0D 56 9A DF 0E 80 7C
+    // Test 2 - Optimized C99 implementation:
+    //  13 12 11 10 0F 0E 0D 0C 0B 0A 09 08 07 06 05 04 03 02 01 00
+    //  7B F7 7B 26 73 7D 2C 26 A2 F1 19 CC F7 0D 56 9A DF 0E 80 7C
 }
 
 
-  
 
+void spongent176_test_perm()
+{
+    uint8_t s[22];
+    int i;
+
+    // 1st test
+    printf("Test 1 - C99 implementation:\n");
+    for (i=0 ; i<22 ; i++) s[i]=i;
+    print_state176(s);
+    permutation176_C99(s);
+    print_state176(s);
+
+    // 2nd test
+    printf("Test 2 - Optimized C99 implementation:\n");
+    for (i=0 ; i<22 ; i++) s[i]=i;
+    print_state176(s);
+    permutation176_C99_V2(s);
+    print_state176(s);
+
+#if defined(SPONGENT_ASSEMBLER)
+    // 3rd test
+    printf("Test 3 - Assembler implementation:\n");
+    for (i=0 ; i<22 ; i++) s[i]=i;
+    print_state176(s);
+    spongent176_msp(s);
+    print_state176(s);
+#endif
 
+    // Expected result
+    // ---------------
+    // Test 1 - C99 implementation:
+    //  15 14 13 12 11 10 0F 0E 0D 0C 0B 0A 09 08 07 06 05 04 03 02 01 00
+    //  26 66 D8 E8 D9 EE 5B 9B E4 C6 E7 61 D0 CD 85 B5 34 35 EB 76 69 D2
+    // Test 2 - Optimized C99 implementation:
+    //  15 14 13 12 11 10 0F 0E 0D 0C 0B 0A 09 08 07 06 05 04 03 02 01 00
+    //  26 66 D8 E8 D9 EE 5B 9B E4 C6 E7 61 D0 CD 85 B5 34 35 EB 76 69 D2
+}
+
+
+
+// Benchmark of the permutation versions on the same input. Each version is
+// executed `iter` times on the state of the 1st test; the printed value is
+// the number of CYCLES() ticks per permutation call times 1000, followed by
+// the first state byte (which is identical for all versions).
+
+void spongent_bench_perm(long iter)
+{
+    uint8_t s[20];
+    unsigned long start, stop;
+    long n;
+    int i;
+
+    for (i=0 ; i<20 ; i++) s[i]=i;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) permutation_C99(s);
+    stop = CYCLES();
+    printf("permutation_C99   : %llu (%02X)\n", TICKS1000(stop - start, iter),
+      s[0]);
+
+    for (i=0 ; i<20 ; i++) s[i]=i;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) permutation_C99_V2(s);
+    stop = CYCLES();
+    printf("permutation_C99_V2: %llu (%02X)\n", TICKS1000(stop - start, iter),
+      s[0]);
+
+#if defined(SPONGENT_ASSEMBLER)
+    for (i=0 ; i<20 ; i++) s[i]=i;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) spongent_msp(s);
+    stop = CYCLES();
+    printf("spongent_msp      : %llu (%02X)\n", TICKS1000(stop - start, iter),
+      s[0]);
+#endif
+}
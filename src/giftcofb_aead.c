@@ -0,0 +1,384 @@
+///////////////////////////////////////////////////////////////////////////////
+// giftcofb_aead.c: C99 implementation and unit-test of GIFT-COFB AEAD.      //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+
+// size of a block, the key, the nonce, and the tag in bytes
+#define BLKSZ 16
+#define NPUBSZ 16
+#define TAGSZ 16
+
+// doubling and tripling of the 64-bit offset in GF(2^64) (with the primitive
+// polynomial x^64 + x^4 + x^3 + x + 1)
+#define DOUBLE(x) (((x) << 1) ^ ((0 - ((x) >> 63)) & 0x1b))
+#define TRIPLE(x) ((x) ^ DOUBLE(x))
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` times 1000 divided by `n`; the result is a
+// ULLInt since 1000*t exceeds 32 bits on MSP430 after 4.29M ticks
+#define TICKS1000(t, n) ((1000*(ULLInt) (t))/(n))
+
+
+extern void gift128f_grk_c99_V1(uint32_t *rkey, const uint8_t *key);
+extern void gift128f_enc_c99(uint8_t *ctxt, const uint8_t *ptxt,
+  const uint32_t *rkey);
+
+#if (defined(__AVR) || defined(__AVR__))
+extern void gift128f_grk_avr(uint32_t *rkey, const uint8_t *key);
+extern void gift128f_enc_avr(uint8_t *ctxt, const uint8_t *ptxt,
+  const uint32_t *rkey);
+#define gift128f_grk(rkey, key) gift128f_grk_avr((rkey), (key))
+#define gift128f_enc(ctxt, ptxt, rkey) gift128f_enc_avr((ctxt), (ptxt), (rkey))
+#elif (defined(__MSP430__) || defined(__ICC430__))
+extern void gift128f_grk_msp(uint32_t *rkey, const uint8_t *key);
+extern void gift128f_enc_msp(uint8_t *ctxt, const uint8_t *ptxt,
+  const uint32_t *rkey);
+#define gift128f_grk(rkey, key) gift128f_grk_msp((rkey), (key))
+#define gift128f_enc(ctxt, ptxt, rkey) gift128f_enc_msp((ctxt), (ptxt), (rkey))
+#else
+#define gift128f_grk(rkey, key) gift128f_grk_c99_V1((rkey), (key))
+#define gift128f_enc(ctxt, ptxt, rkey) gift128f_enc_c99((ctxt), (ptxt), (rkey))
+#endif
+
+
+// Key object of GIFT-COFB. It holds the 80 round-keys of fix-sliced GIFT-128,
+// which are computed once by giftcofb_setkey and then used for all messages
+// that are encrypted or decrypted under this key.
+
+typedef struct GiftCofbKey {
+  uint32_t rkey[80];
+} GiftCofbKey;
+
+
+// Size of the key object in bytes. Other source files only see the incomplete
+// type `struct GiftCofbKey` and use this function to allocate a key object.
+
+size_t giftcofb_keysize(void)
+{
+  return sizeof(GiftCofbKey);
+}
+
+
+// Key set-up of GIFT-COFB: the 80 round-keys of fix-sliced GIFT-128 (320
+// bytes, i.e. the whole key object) are computed from the 128-bit `key` with
+// the key schedule of the target. The key object can then be used for any
+// number of calls of giftcofb_aead_encrypt and giftcofb_aead_decrypt.
+
+void giftcofb_setkey(GiftCofbKey *gk, const UChar *key)
+{
+  gift128f_grk(gk->rkey, key);
+}
+
+
+// Feedback function of COFB: the next block-cipher input `x` is initialized
+// with G(Y) XOR (delta || 0^64), where G maps (Y1 || Y2) to (Y2 || Y1 <<< 1)
+// for the two 64-bit halves of the last block-cipher output `y`. The
+// (padded) data block is XORed to `x` afterwards.
+
+static void giftcofb_feedback(UChar *x, const UChar *y, uint64_t delta)
+{
+  int i;
+
+  for (i = 0; i < 8; i++) {
+    x[i] = y[i+8] ^ (UChar) (delta >> (56 - 8*i));
+    x[i+8] = (y[i] << 1) | (y[(i+1)&7] >> 7);
+  }
+}
+
+
+// Processing of the associated data. The first block-cipher output `y` is
+// E_K(N), whose upper half is also the initial offset `delta`. The offset is
+// doubled for every block except the last one, which gets a factor of 3
+// (full block) or 3^2 (partial or empty block), and another factor of 3^2
+// if the message is empty. Returns the offset after the last AD block.
+
+static uint64_t giftcofb_ad(UChar *y, UChar *x, const UChar *ad, size_t adlen,
+  size_t mlen, const GiftCofbKey *gk)
+{
+  uint64_t delta = 0;
+  size_t i;
+
+  for (i = 0; i < 8; i++) delta = (delta << 8) | y[i];
+
+  for (; adlen > BLKSZ; adlen -= BLKSZ, ad += BLKSZ) {
+    delta = DOUBLE(delta);
+    giftcofb_feedback(x, y, delta);
+    for (i = 0; i < BLKSZ; i++) x[i] ^= ad[i];
+    gift128f_enc(y, x, gk->rkey);
+  }
+
+  delta = TRIPLE(delta);
+  if (adlen < BLKSZ) delta = TRIPLE(delta);
+  if (mlen == 0) delta = TRIPLE(TRIPLE(delta));
+  giftcofb_feedback(x, y, delta);
+  for (i = 0; i < adlen; i++) x[i] ^= ad[i];
+  if (adlen < BLKSZ) x[adlen] ^= 0x80;
+  gift128f_enc(y, x, gk->rkey);
+
+  return delta;
+}
+
+
+// Encryption (`enc` = 1) or decryption (`enc` = 0) of the message. Each
+// block is XORed with the last block-cipher output `y` to get the output
+// block, while the plaintext block is fed into the next block-cipher input
+// `x`. The block cipher reads `x` and writes `y` directly, i.e. there are no
+// other intermediate buffers; `out` can be the same buffer as `in`.
+
+static void giftcofb_msg(UChar *out, UChar *y, UChar *x, const UChar *in,
+  size_t len, uint64_t delta, int enc, const GiftCofbKey *gk)
+{
+  size_t i;
+  UChar t;
+
+  for (; len > BLKSZ; len -= BLKSZ, in += BLKSZ, out += BLKSZ) {
+    delta = DOUBLE(delta);
+    giftcofb_feedback(x, y, delta);
+    for (i = 0; i < BLKSZ; i++) {
+      t = in[i] ^ y[i];
+      x[i] ^= enc ? in[i] : t;
+      out[i] = t;
+    }
+    gift128f_enc(y, x, gk->rkey);
+  }
+
+  if (len > 0) {
+    delta = TRIPLE(delta);
+    if (len < BLKSZ) delta = TRIPLE(delta);
+    giftcofb_feedback(x, y, delta);
+    for (i = 0; i < len; i++) {
+      t = in[i] ^ y[i];
+      x[i] ^= enc ? in[i] : t;
+      out[i] = t;
+    }
+    if (len < BLKSZ) x[len] ^= 0x80;
+    gift128f_enc(y, x, gk->rkey);
+  }
+}
+
+
+// Encryption with a key object; the ciphertext has the same length as the
+// message and the tag is the last block-cipher output. Encryption in place
+// (i.e. `c` = `m`) is supported.
+
+void giftcofb_aead_encrypt(UChar *c, UChar *tag, const UChar *m, size_t mlen,
+  const UChar *ad, size_t adlen, const UChar *npub, const GiftCofbKey *gk)
+{
+  uint32_t x[BLKSZ/4], y[BLKSZ/4];  // 32-bit aligned for gift128f_enc_c99
+  uint64_t delta;
+
+  memcpy(x, npub, NPUBSZ);
+  gift128f_enc((UChar *) y, (UChar *) x, gk->rkey);
+  delta = giftcofb_ad((UChar *) y, (UChar *) x, ad, adlen, mlen, gk);
+  giftcofb_msg(c, (UChar *) y, (UChar *) x, m, mlen, delta, 1, gk);
+  memcpy(tag, y, TAGSZ);
+}
+
+
+// Decryption with a key object. Since the tag of COFB depends on the
+// plaintext, the message is decrypted first and the tag is then verified in
+// constant time; in the case of a forgery, -1 is returned and the decrypted
+// message is cleared.
+
+int giftcofb_aead_decrypt(UChar *m, const UChar *c, size_t clen,
+  const UChar *tag, const UChar *ad, size_t adlen, const UChar *npub,
+  const GiftCofbKey *gk)
+{
+  uint32_t x[BLKSZ/4], y[BLKSZ/4];
+  uint64_t delta;
+  UChar diff = 0;
+  int i;
+
+  memcpy(x, npub, NPUBSZ);
+  gift128f_enc((UChar *) y, (UChar *) x, gk->rkey);
+  delta = giftcofb_ad((UChar *) y, (UChar *) x, ad, adlen, clen, gk);
+  giftcofb_msg(m, (UChar *) y, (UChar *) x, c, clen, delta, 0, gk);
+  for (i = 0; i < TAGSZ; i++) diff |= ((UChar *) y)[i] ^ tag[i];
+  if (diff != 0) {
+    memset(m, 0, clen);
+    return -1;
+  }
+
+  return 0;
+}
+
+
+// Print a byte-array in Hex format (the output is limited to the first 64
+// bytes of the byte-array).
+
+static void print_bytes(const char* str, const UChar *bytearray, size_t len)
+{
+  UChar buffer[148], byte;
+  size_t i, j, slen = 0;
+
+  if (str != NULL) {
+    slen = MIN(16, strlen(str));
+    memcpy(buffer, str, slen);
+  }
+
+  j = slen;
+  for (i = 0; i < MIN(64, len); i++) {
+    byte = bytearray[i] >> 4;
+    // replace 87 by 55 to get uppercase letters
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+    byte = bytearray[i] & 0xf;
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+  }
+  if (len > 64) {
+    buffer[j] = buffer[j+1] = buffer[j+2] = '.';
+    j += 3;
+  }
+  buffer[j] = '\0';
+
+  printf("%s\n", buffer);
+}
+
+
+// Simple test function for GIFT-COFB. The 1st test uses the key and nonce of
+// the NIST KAT files with empty message and associated data, the 2nd test
+// encrypts a 41-byte message with 32 bytes of associated data (in place) and
+// decrypts it again, the 3rd test checks that a tampered ciphertext is
+// rejected (and the output cleared), and the 4th test reuses one key object
+// for all combinations of message and AD lengths from 0 to 48 bytes; the
+// tags are XORed together and all ciphertexts are decrypted again.
+
+void giftcofb_test_aead(void)
+{
+  UChar key[16], npub[NPUBSZ], ad[48], msg[48], buf[48], tag[TAGSZ];
+  UChar sum[TAGSZ];
+  GiftCofbKey gk;
+  int i, j, res, err = 0;
+
+  for (i = 0; i < 16; i++) key[i] = (UChar) i;
+  for (i = 0; i < NPUBSZ; i++) npub[i] = (UChar) i;
+  for (i = 0; i < 48; i++) ad[i] = msg[i] = (UChar) i;
+  memset(buf, 0, sizeof(buf));
+  giftcofb_setkey(&gk, key);
+
+  // 1st test: empty message and empty associated data
+
+  printf("Test 1 - C99 implementation:\n");
+  giftcofb_aead_encrypt(buf, tag, buf, 0, ad, 0, npub, &gk);
+  print_bytes("Tag: ", tag, TAGSZ);
+
+  // 2nd test: in-place encryption and decryption
+
+  printf("Test 2 - C99 implementation:\n");
+  for (i = 0; i < 41; i++) buf[i] = (UChar) i;
+  giftcofb_aead_encrypt(buf, tag, buf, 41, ad, 32, npub, &gk);
+  print_bytes("CT:  ", buf, 41);
+  print_bytes("Tag: ", tag, TAGSZ);
+  res = giftcofb_aead_decrypt(buf, buf, 41, tag, ad, 32, npub, &gk);
+  print_bytes("PT:  ", buf, 41);
+  printf("Verification: %s\n", (res == 0) ? "ok" : "failed");
+
+  // 3rd test: a flipped bit in the ciphertext must be detected
+
+  printf("Test 3 - C99 implementation:\n");
+  giftcofb_aead_encrypt(buf, tag, buf, 41, ad, 32, npub, &gk);
+  buf[40] ^= 0x01;
+  res = giftcofb_aead_decrypt(buf, buf, 41, tag, ad, 32, npub, &gk);
+  printf("Verification: %s\n", (res == 0) ? "ok" : "failed");
+  print_bytes("PT:  ", buf, 41);
+
+  // 4th test: one key object for 49*49 messages
+
+  printf("Test 4 - C99 implementation:\n");
+  memset(sum, 0, sizeof(sum));
+  for (i = 0; i <= 48; i++) {
+    for (j = 0; j <= 48; j++) {
+      giftcofb_aead_encrypt(buf, tag, msg, i, ad, j, npub, &gk);
+      for (res = 0; res < TAGSZ; res++) sum[res] ^= tag[res];
+      res = giftcofb_aead_decrypt(buf, buf, i, tag, ad, j, npub, &gk);
+      if (res != 0 || memcmp(buf, msg, i) != 0) err++;
+    }
+  }
+  print_bytes("Sum: ", sum, TAGSZ);
+  printf("Mismatches: %i\n", err);
+
+  // Expected result
+  // ---------------
+  // Test 1 - C99 implementation:
+  // Tag: 368965836d36614de2fc24d0f801b9af
+  // Test 2 - C99 implementation:
+  // CT:  baf563c60fbeddc5662995f4c678be80a7f7de9b3ad8c97aa6ca17016d2ae650bce3b3e99bfbd47164
+  // Tag: 352098c60168eb5351fb1440412edc6b
+  // PT:  000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728
+  // Verification: ok
+  // Test 3 - C99 implementation:
+  // Verification: failed
+  // PT:  0000000000000000000000000000000000000000000000000000000000000000000000000000000000
+  // Test 4 - C99 implementation:
+  // Sum: 697d938fe565ae538d755166e3c3bc34
+  // Mismatches: 0
+}
+
+
+// Benchmark of GIFT-COFB. Messages of different lengths (without associated
+// data) are encrypted `iter` times under one key object; the printed values
+// are the number of CYCLES() ticks per encryption and per byte times 1000.
+// The cost of the key set-up is measured separately.
+
+void giftcofb_bench_aead(long iter)
+{
+  static const size_t len[4] = { 16, 64, 256, 1024 };
+  static UChar buf[1024];
+  UChar key[16], npub[NPUBSZ], tag[TAGSZ];
+  unsigned long start, t;
+  GiftCofbKey gk;
+  long n;
+  int i;
+
+  for (i = 0; i < 16; i++) key[i] = (UChar) i;
+  for (i = 0; i < NPUBSZ; i++) npub[i] = (UChar) i;
+  for (i = 0; i < 1024; i++) buf[i] = (UChar) i;
+
+  start = CYCLES();
+  for (n = 0; n < iter; n++) {
+    key[0] ^= buf[0];
+    giftcofb_setkey(&gk, key);
+  }
+  t = CYCLES() - start;
+  printf("giftcofb_setkey: %llu\n", TICKS1000(t, iter));
+
+  for (i = 0; i < 4; i++) {
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      giftcofb_aead_encrypt(buf, tag, buf, len[i], NULL, 0, npub, &gk);
+    }
+    t = CYCLES() - start;
+    printf("%4i bytes: %llu (%llu per byte)\n", (int) len[i],
+      TICKS1000(t, iter), TICKS1000(t, (ULLInt) iter*MAX(len[i], 1)));
+  }
+}
@@ -342,6 +342,10 @@ extern void gift128f_grk_msp(uint32_t *rkey, const uint8_t *key);
 #define gift128f_enc_asm(ctxt, ptxt, rkey) \
   gift128f_enc_msp((ctxt), (ptxt), (rkey))
 #define gift128f_grk_asm(rkey, key) gift128f_grk_msp((rkey), (key));
+extern void gift128f_enc_otf_msp(uint8_t *ctxt, const uint8_t *ptxt,
+  const uint8_t *key);
+#define gift128f_enc_otf_asm(ctxt, ptxt, key) \
+  gift128f_enc_otf_msp((ctxt), (ptxt), (key))
 #define GIFTCOFB_ASSEMBLER
 #endif
 
@@ -371,6 +375,62 @@ void gift128f_enc_c99(uint8_t *ctxt, const uint8_t *ptxt, const uint32_t *rkey)
 }
 
 
+// The low-memory version of the fix-sliced GIFT-128 encryption generates the
+// round-keys on the fly, i.e. it does not need the 80-word rkey-array. The
+// classical key-schedule is performed on a window of four 32-bit words (the
+// round-keys of round r and r+1) and the ten round-keys of a quintuple-round
+// are rearranged into fix-sliced representation right before they are used,
+// in the same way as in gift128f_grk_c99_V2. Only 56 bytes of RAM are needed
+// for the window and the round-keys of one quintuple-round.
+
+void gift128f_enc_otf_c99(uint8_t *ctxt, const uint8_t *ptxt,
+  const uint8_t *key)
+{
+  uint32_t state[4], kwin[4], rk[10], tmp;
+  int i, j;
+
+  state[0] = U32BIG(((uint32_t *) ptxt)[0]);
+  state[1] = U32BIG(((uint32_t *) ptxt)[1]);
+  state[2] = U32BIG(((uint32_t *) ptxt)[2]);
+  state[3] = U32BIG(((uint32_t *) ptxt)[3]);
+
+  // classical initialization
+  kwin[0] = U32BIG(((uint32_t *) key)[3]);
+  kwin[1] = U32BIG(((uint32_t *) key)[1]);
+  kwin[2] = U32BIG(((uint32_t *) key)[2]);
+  kwin[3] = U32BIG(((uint32_t *) key)[0]);
+
+  for (i = 0; i < MAXROUNDS; i += 5) {
+    // classical key-schedule for five rounds: round-keys of round r are the
+    // first two words of the window, which is then shifted by one round
+    for (j = 0; j < 10; j += 2) {
+      rk[j] = kwin[0];
+      rk[j+1] = kwin[1];
+      tmp = KEY_UPDATE(kwin[0]);
+      kwin[0] = kwin[2];
+      kwin[2] = kwin[1];
+      kwin[1] = kwin[3];
+      kwin[3] = tmp;
+    }
+    // transposition to fix-sliced representation
+    REARRANGE_RKEY_0(rk[0]);
+    REARRANGE_RKEY_0(rk[1]);
+    REARRANGE_RKEY_1(rk[2]);
+    REARRANGE_RKEY_1(rk[3]);
+    REARRANGE_RKEY_2(rk[4]);
+    REARRANGE_RKEY_2(rk[5]);
+    REARRANGE_RKEY_3(rk[6]);
+    REARRANGE_RKEY_3(rk[7]);
+    QUINTUPLE_ROUND(state, rk, rconst + i);
+  }
+
+  U8BIG(ctxt, state[0]);
+  U8BIG(ctxt + 4, state[1]);
+  U8BIG(ctxt + 8, state[2]);
+  U8BIG(ctxt + 12, state[3]);
+}
+
+
 // Print plain/ciphertext-words or key-words of GIFT128 in Hex format.
 
 static void print_words(const uint32_t *w, int len)
@@ -470,6 +530,22 @@ void giftcofb_test_cipher(void)
   print_words((uint32_t *) ctxt, 4);
 #endif
 
+  // 3rd test: same as 2nd test, but with round-keys generated on the fly
+
+  printf("Test 3 - C99 implementation (on-the-fly):\n");
+  for (i = 0; i < 16; i++) ptxt[i] = (uint8_t) i;
+  print_words((uint32_t *) ptxt, 4);
+  gift128f_enc_otf_c99(ctxt, ptxt, key);  // encryption in C
+  print_words((uint32_t *) ctxt, 4);
+
+#if defined(gift128f_enc_otf_asm)
+  printf("Test 3 - ASM implementation (on-the-fly):\n");
+  for (i = 0; i < 16; i++) ptxt[i] = (uint8_t) i;
+  print_words((uint32_t *) ptxt, 4);
+  gift128f_enc_otf_asm(ctxt, ptxt, key);  // encryption in ASM
+  print_words((uint32_t *) ctxt, 4);
+#endif
+
   // Expected result for 40 rounds
   // -----------------------------
   // Test 1 - C99 implementation:
@@ -484,4 +560,10 @@ void giftcofb_test_cipher(void)
   // Test 2 - ASM implementation:
   // 03020100 07060504 0b0a0908 0f0e0d0c
   // 6ecc9848 c6c75cf0 17fbfb70 092b90e9
+  // Test 3 - C99 implementation (on-the-fly):
+  // 03020100 07060504 0b0a0908 0f0e0d0c
+  // 6ecc9848 c6c75cf0 17fbfb70 092b90e9
+  // Test 3 - ASM implementation (on-the-fly):
+  // 03020100 07060504 0b0a0908 0f0e0d0c
+  // 6ecc9848 c6c75cf0 17fbfb70 092b90e9
 }
@@ -0,0 +1,371 @@
+///////////////////////////////////////////////////////////////////////////////
+// giftcofb_multi.c: Multi-block implementation and unit-test of GIFT-128.   //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+
+#define MAXROUNDS 40
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` times 1000 divided by `n`; the result is a
+// ULLInt since 1000*t exceeds 32 bits on MSP430 after 4.29M ticks
+#define TICKS1000(t, n) ((1000*(ULLInt) (t))/(n))
+
+
+extern const uint32_t rconst[40];
+extern void gift128f_grk_c99_V1(uint32_t *rkey, const uint8_t *key);
+extern void gift128f_enc_c99(uint8_t *ctxt, const uint8_t *ptxt,
+  const uint32_t *rkey);
+
+
+// The scalar fallback encrypts the blocks one after the other. The `n` blocks
+// of `ptxt` and `ctxt` are stored one after the other (16 bytes each), and
+// block `i` is encrypted with the round-keys `rkey[i]`, i.e. the blocks can
+// belong to different keys (or all pointers can refer to the same rkey).
+
+void gift128f_enc_multi_c99(uint8_t *ctxt, const uint8_t *ptxt,
+  const uint32_t *const *rkey, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++) gift128f_enc_c99(ctxt + 16*i, ptxt + 16*i, rkey[i]);
+}
+
+
+#if defined(__AVX2__)
+
+// The 8-way AVX2 version keeps word j of the eight states in vector s[j], so
+// that the fix-sliced round functions of giftcofb_cipher.c translate one to
+// one into operations on eight 32-bit lanes. Rotations by a multiple of 8
+// bits are executed as byte shuffles.
+
+#define XOR256(x, y) _mm256_xor_si256((x), (y))
+#define AND256(x, y) _mm256_and_si256((x), (y))
+
+#define ROR256(x, y) _mm256_or_si256(_mm256_srli_epi32((x), (y)), \
+  _mm256_slli_epi32((x), 32 - (y)))
+
+// ((x >> r) & mr) | ((x & ml) << l) for each 32-bit lane
+#define SHIFTMASK(x, r, mr, l, ml) _mm256_or_si256( \
+  AND256(_mm256_srli_epi32((x), (r)), _mm256_set1_epi32(mr)), \
+  _mm256_slli_epi32(AND256((x), _mm256_set1_epi32(ml)), (l)))
+
+#define BYTE_ROR_2(x) SHIFTMASK((x), 2, 0x3f3f3f3f, 6, 0x03030303)
+#define BYTE_ROR_4(x) SHIFTMASK((x), 4, 0x0f0f0f0f, 4, 0x0f0f0f0f)
+#define BYTE_ROR_6(x) SHIFTMASK((x), 6, 0x03030303, 2, 0x3f3f3f3f)
+
+#define HALF_ROR_4(x) SHIFTMASK((x), 4, 0x0fff0fff, 12, 0x000f000f)
+#define HALF_ROR_12(x) SHIFTMASK((x), 12, 0x000f000f, 4, 0x0fff0fff)
+
+#define NIBBLE_ROR_1(x) SHIFTMASK((x), 1, 0x77777777, 3, 0x11111111)
+#define NIBBLE_ROR_2(x) SHIFTMASK((x), 2, 0x33333333, 2, 0x33333333)
+#define NIBBLE_ROR_3(x) SHIFTMASK((x), 3, 0x11111111, 1, 0x77777777)
+
+// byte permutations for HALF_ROR_8 and the rotations by 8, 16, and 24 bits
+#define SHUFFLE(b0, b1, b2, b3) _mm256_set_epi8( \
+  28+b3, 28+b2, 28+b1, 28+b0, 24+b3, 24+b2, 24+b1, 24+b0, \
+  20+b3, 20+b2, 20+b1, 20+b0, 16+b3, 16+b2, 16+b1, 16+b0, \
+  12+b3, 12+b2, 12+b1, 12+b0, 8+b3, 8+b2, 8+b1, 8+b0, \
+  4+b3, 4+b2, 4+b1, 4+b0, b3, b2, b1, b0)
+
+#define SWAPMOVE256(x, mask, n) do { \
+  __m256i t_ = AND256(XOR256((x), _mm256_srli_epi32((x), (n))), \
+    _mm256_set1_epi32(mask)); \
+  (x) = XOR256(XOR256((x), t_), _mm256_slli_epi32(t_, (n))); \
+} while (0)
+
+#define SBOX256(s0, s1, s2, s3) do { \
+  s1 = XOR256(s1, AND256(s0, s2)); \
+  s0 = XOR256(s0, AND256(s1, s3)); \
+  s2 = XOR256(s2, _mm256_or_si256(s0, s1)); \
+  s3 = XOR256(s3, s2); \
+  s1 = XOR256(s1, s3); \
+  s3 = XOR256(s3, ones); \
+  s2 = XOR256(s2, AND256(s0, s1)); \
+} while (0)
+
+#define QUINTUPLE_ROUND256(s, rk, rc) do { \
+  __m256i t_; \
+  SBOX256(s[0], s[1], s[2], s[3]); \
+  s[3] = NIBBLE_ROR_1(s[3]); \
+  s[1] = NIBBLE_ROR_2(s[1]); \
+  s[2] = NIBBLE_ROR_3(s[2]); \
+  s[1] = XOR256(s[1], (rk)[0]); \
+  s[2] = XOR256(s[2], (rk)[1]); \
+  s[0] = XOR256(s[0], _mm256_set1_epi32((rc)[0])); \
+  SBOX256(s[3], s[1], s[2], s[0]); \
+  s[0] = HALF_ROR_4(s[0]); \
+  s[1] = _mm256_shuffle_epi8(s[1], half_ror8); \
+  s[2] = HALF_ROR_12(s[2]); \
+  s[1] = XOR256(s[1], (rk)[2]); \
+  s[2] = XOR256(s[2], (rk)[3]); \
+  s[3] = XOR256(s[3], _mm256_set1_epi32((rc)[1])); \
+  SBOX256(s[0], s[1], s[2], s[3]); \
+  s[3] = _mm256_shuffle_epi8(s[3], ror16); \
+  s[2] = _mm256_shuffle_epi8(s[2], ror16); \
+  SWAPMOVE256(s[1], 0x55555555, 1); \
+  SWAPMOVE256(s[2], 0x00005555, 1); \
+  SWAPMOVE256(s[3], 0x55550000, 1); \
+  s[1] = XOR256(s[1], (rk)[4]); \
+  s[2] = XOR256(s[2], (rk)[5]); \
+  s[0] = XOR256(s[0], _mm256_set1_epi32((rc)[2])); \
+  SBOX256(s[3], s[1], s[2], s[0]); \
+  s[0] = BYTE_ROR_6(s[0]); \
+  s[1] = BYTE_ROR_4(s[1]); \
+  s[2] = BYTE_ROR_2(s[2]); \
+  s[1] = XOR256(s[1], (rk)[6]); \
+  s[2] = XOR256(s[2], (rk)[7]); \
+  s[3] = XOR256(s[3], _mm256_set1_epi32((rc)[3])); \
+  SBOX256(s[0], s[1], s[2], s[3]); \
+  s[3] = _mm256_shuffle_epi8(s[3], ror24); \
+  s[1] = _mm256_shuffle_epi8(s[1], ror16); \
+  s[2] = _mm256_shuffle_epi8(s[2], ror8); \
+  s[1] = XOR256(s[1], (rk)[8]); \
+  s[2] = XOR256(s[2], (rk)[9]); \
+  s[0] = XOR256(s[0], _mm256_set1_epi32((rc)[4])); \
+  t_ = s[0]; s[0] = s[3]; s[3] = t_; \
+} while (0)
+
+// transpose of an 8x8 matrix of 32-bit words held in eight vectors
+#define TRANSPOSE8X8(r) do { \
+  __m256i a0_, a1_, a2_, a3_, a4_, a5_, a6_, a7_; \
+  a0_ = _mm256_unpacklo_epi32(r[0], r[1]); \
+  a1_ = _mm256_unpackhi_epi32(r[0], r[1]); \
+  a2_ = _mm256_unpacklo_epi32(r[2], r[3]); \
+  a3_ = _mm256_unpackhi_epi32(r[2], r[3]); \
+  a4_ = _mm256_unpacklo_epi32(r[4], r[5]); \
+  a5_ = _mm256_unpackhi_epi32(r[4], r[5]); \
+  a6_ = _mm256_unpacklo_epi32(r[6], r[7]); \
+  a7_ = _mm256_unpackhi_epi32(r[6], r[7]); \
+  r[0] = _mm256_unpacklo_epi64(a0_, a2_); \
+  r[1] = _mm256_unpackhi_epi64(a0_, a2_); \
+  r[2] = _mm256_unpacklo_epi64(a1_, a3_); \
+  r[3] = _mm256_unpackhi_epi64(a1_, a3_); \
+  r[4] = _mm256_unpacklo_epi64(a4_, a6_); \
+  r[5] = _mm256_unpackhi_epi64(a4_, a6_); \
+  r[6] = _mm256_unpacklo_epi64(a5_, a7_); \
+  r[7] = _mm256_unpackhi_epi64(a5_, a7_); \
+  a0_ = _mm256_permute2x128_si256(r[0], r[4], 0x20); \
+  a1_ = _mm256_permute2x128_si256(r[1], r[5], 0x20); \
+  a2_ = _mm256_permute2x128_si256(r[2], r[6], 0x20); \
+  a3_ = _mm256_permute2x128_si256(r[3], r[7], 0x20); \
+  a4_ = _mm256_permute2x128_si256(r[0], r[4], 0x31); \
+  a5_ = _mm256_permute2x128_si256(r[1], r[5], 0x31); \
+  a6_ = _mm256_permute2x128_si256(r[2], r[6], 0x31); \
+  a7_ = _mm256_permute2x128_si256(r[3], r[7], 0x31); \
+  r[0] = a0_; r[1] = a1_; r[2] = a2_; r[3] = a3_; \
+  r[4] = a4_; r[5] = a5_; r[6] = a6_; r[7] = a7_; \
+} while (0)
+
+
+// The 8-way AVX2 version encrypts eight blocks. The round-keys are brought
+// into the vector format at the beginning: if all eight lanes use the same
+// rkey, each round-key word is simply broadcast, otherwise eight words of
+// each lane are loaded at a time and transposed.
+
+void gift128f_enc_x8_avx2(uint8_t *ctxt, const uint8_t *ptxt,
+  const uint32_t *const *rkey)
+{
+  const __m256i ones = _mm256_set1_epi32(-1);
+  const __m256i bswap = SHUFFLE(3, 2, 1, 0);
+  const __m256i half_ror8 = SHUFFLE(1, 0, 3, 2);
+  const __m256i ror8 = SHUFFLE(1, 2, 3, 0);
+  const __m256i ror16 = SHUFFLE(2, 3, 0, 1);
+  const __m256i ror24 = SHUFFLE(3, 0, 1, 2);
+  const __m256i idx = _mm256_set_epi32(28, 24, 20, 16, 12, 8, 4, 0);
+  __m256i rk[2*MAXROUNDS], s[4];
+  uint32_t w[4][8];
+  int i, j, shared = 1;
+
+  // round-keys
+  for (j = 1; j < 8; j++) shared &= (rkey[j] == rkey[0]);
+  if (shared) {
+    for (i = 0; i < 2*MAXROUNDS; i++) rk[i] = _mm256_set1_epi32(rkey[0][i]);
+  } else {
+    for (i = 0; i < 2*MAXROUNDS; i += 8) {
+      for (j = 0; j < 8; j++)
+        rk[i+j] = _mm256_loadu_si256((const __m256i *) (rkey[j] + i));
+      TRANSPOSE8X8((rk + i));
+    }
+  }
+
+  // word j of the eight blocks (big-endian) into vector s[j]
+  for (j = 0; j < 4; j++) {
+    s[j] = _mm256_i32gather_epi32((const int *) ptxt + j, idx, 4);
+    s[j] = _mm256_shuffle_epi8(s[j], bswap);
+  }
+
+  for (i = 0; i < MAXROUNDS; i += 5) {
+    QUINTUPLE_ROUND256(s, rk + 2*i, rconst + i);
+  }
+
+  for (j = 0; j < 4; j++) {
+    s[j] = _mm256_shuffle_epi8(s[j], bswap);
+    _mm256_storeu_si256((__m256i *) w[j], s[j]);
+  }
+  for (i = 0; i < 8; i++) {
+    for (j = 0; j < 4; j++) memcpy(ctxt + 16*i + 4*j, &w[j][i], 4);
+  }
+}
+
+#endif  // defined(__AVX2__)
+
+
+// Batched encryption of an arbitrary number of blocks: groups of eight
+// blocks are processed with AVX2 (when it is enabled at compile time) and
+// the rest with the scalar fallback. The result is identical to `n` calls of
+// gift128f_enc_c99.
+
+void gift128f_enc_multi(uint8_t *ctxt, const uint8_t *ptxt,
+  const uint32_t *const *rkey, int n)
+{
+  int i = 0;
+
+#if defined(__AVX2__)
+  for (; i + 8 <= n; i += 8) {
+    gift128f_enc_x8_avx2(ctxt + 16*i, ptxt + 16*i, rkey + i);
+  }
+#endif
+  gift128f_enc_multi_c99(ctxt + 16*i, ptxt + 16*i, rkey + i, n - i);
+}
+
+
+// Print plain/ciphertext-words of GIFT128 in Hex format.
+
+static void print_words(const uint32_t *w, int len)
+{
+  uint8_t buffer[85], byte;
+  int i, j, k = 0;
+
+  for (i = 0; i < len; i++) {
+    for (j = 7; j >= 0; j--) {
+      byte = (w[i] >> 4*j) & 0xf;
+      // replace 87 by 55 to get uppercase letters
+      buffer[k++] = byte + ((byte < 10) ? 48 : 87);
+    }
+    buffer[k++] = ' ';
+  }
+  buffer[k-1] = '\0';
+
+  printf("%s\n", buffer);
+}
+
+
+// Simple test function for the batched GIFT-128 encryption. 19 blocks (two
+// groups of eight and a partial group of three) with byte-indeces plus a
+// block-specific offset are encrypted under three different keys; the first
+// group uses the same key for all blocks, the others mix the keys. Every
+// block is compared with gift128f_enc_c99 and block 0 (key 128, ..., 143,
+// plaintext 0, ..., 15) is printed, which matches Test 2 of
+// giftcofb_test_cipher.
+
+void giftcofb_test_multi(void)
+{
+  uint32_t rk[3][80], pt[19][4], ct[19][4], t[4];
+  const uint32_t *rkey[19];
+  uint8_t key[16];
+  int i, j, errors = 0;
+
+  for (j = 0; j < 3; j++) {
+    for (i = 0; i < 16; i++) key[i] = (uint8_t) (128 + i + 16*j);
+    gift128f_grk_c99_V1(rk[j], key);
+  }
+  for (j = 0; j < 19; j++) {
+    for (i = 0; i < 16; i++) ((uint8_t *) pt[j])[i] = (uint8_t) (i + 16*j);
+    rkey[j] = rk[(j < 8) ? 0 : j % 3];
+  }
+
+  printf("Test 1 - Multi-block implementation:\n");
+  gift128f_enc_multi((uint8_t *) ct, (const uint8_t *) pt, rkey, 19);
+  print_words(pt[0], 4);
+  print_words(ct[0], 4);
+
+  for (j = 0; j < 19; j++) {
+    gift128f_enc_c99((uint8_t *) t, (const uint8_t *) pt[j], rkey[j]);
+    errors += (memcmp(t, ct[j], 16) != 0);
+  }
+  printf("Blocks differing from gift128f_enc_c99: %i\n", errors);
+
+  // Expected result
+  // ---------------
+  // Test 1 - Multi-block implementation:
+  // 03020100 07060504 0b0a0908 0f0e0d0c
+  // 6ecc9848 c6c75cf0 17fbfb70 092b90e9
+  // Blocks differing from gift128f_enc_c99: 0
+}
+
+
+// Benchmark of the batched GIFT-128 encryption for 8, 64, and 256 blocks,
+// with a shared key and with a separate key for every block. The printed
+// figures are the number of CYCLES() ticks per byte times 1000 of the scalar
+// and the batched path, and the first byte of the result (to prevent the
+// compiler from optimizing the loops away).
+
+void giftcofb_bench_multi(long iter)
+{
+  static uint32_t rk[256][80];
+  static uint8_t buf[256*16];
+  static const uint32_t *rkey[256];
+  int size[3] = { 8, 64, 256 };
+  unsigned long start, t_c99, t_multi;
+  uint8_t key[16];
+  int i, j, k;
+  long n;
+
+  memset(buf, 0, sizeof(buf));
+  for (j = 0; j < 256; j++) {
+    for (i = 0; i < 16; i++) key[i] = (uint8_t) (i + j);
+    gift128f_grk_c99_V1(rk[j], key);
+  }
+
+  for (k = 0; k < 2; k++) {
+    for (j = 0; j < 256; j++) rkey[j] = rk[k ? j : 0];
+    for (i = 0; i < 3; i++) {
+      start = CYCLES();
+      for (n = 0; n < iter; n++) gift128f_enc_multi_c99(buf, buf, rkey,
+        size[i]);
+      t_c99 = CYCLES() - start;
+      start = CYCLES();
+      for (n = 0; n < iter; n++) gift128f_enc_multi(buf, buf, rkey, size[i]);
+      t_multi = CYCLES() - start;
+      printf("%3i blocks, %s: c99 %llu, multi %llu (%02X)\n", size[i],
+        k ? "own keys  " : "shared key",
+        TICKS1000(t_c99, 16*(ULLInt) iter*size[i]),
+        TICKS1000(t_multi, 16*(ULLInt) iter*size[i]), buf[0]);
+    }
+  }
+}
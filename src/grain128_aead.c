@@ -0,0 +1,725 @@
+///////////////////////////////////////////////////////////////////////////////
+// grain128_aead.c: C99 implementation and unit-test of Grain-128AEADv2 AEAD //
+// Version 1.0.0 (30-11-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#if defined(__PCLMUL__)
+#include <immintrin.h>
+#endif
+
+
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+
+// Same type definition as in grain128_cipher.c. After the initialization,
+// `A` and `R` are the 64-bit accumulator and shift register of the MAC, and
+// `z` and `S` contain the message keystream and authentication keystream bits
+// of the last pre-output word that have not been used yet. Both are preceded
+// by a 1-bit that marks their number, i.e. `z` is 1 when all keystream bits
+// of the last pre-output word have been consumed.
+
+typedef struct {
+  uint32_t lfsr[4];  // LFSR
+  uint32_t nfsr[4];  // NFSR
+  uint64_t A, R, S;  // Accumulator, Register, and next Auth-keystream
+  uint32_t z;        // Message-keystream
+} grain_ctx;
+
+
+// size of the key, the nonce, and the tag in bytes
+#define KEYSZ 16
+#define NPUBSZ 12
+#define TAGSZ 8
+
+// number of initialization clocks with pre-output feedback (of which the last
+// 64 clocks also re-introduce the key)
+#define INITCLKS 384
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// load/store of a little-endian 64-bit word from/to an unaligned byte-array
+#define LOAD64(p) (((uint64_t) (p)[7] << 56) | ((uint64_t) (p)[6] << 48) | \
+  ((uint64_t) (p)[5] << 40) | ((uint64_t) (p)[4] << 32) | \
+  ((uint64_t) (p)[3] << 24) | ((uint64_t) (p)[2] << 16) | \
+  ((uint64_t) (p)[1] <<  8) | ((uint64_t) (p)[0]))
+#define STORE64(p, x) do { (p)[7] = (UChar) ((x) >> 56); \
+  (p)[6] = (UChar) ((x) >> 48); (p)[5] = (UChar) ((x) >> 40); \
+  (p)[4] = (UChar) ((x) >> 32); (p)[3] = (UChar) ((x) >> 24); \
+  (p)[2] = (UChar) ((x) >> 16); (p)[1] = (UChar) ((x) >>  8); \
+  (p)[0] = (UChar) (x); } while (0)
+
+// swap-move operation within a word
+#define SWAPMOVE(x, mask, n) do { KsWord t_ = (((x) >> (n)) ^ (x)) & (mask); \
+  (x) ^= t_ ^ (t_ << (n)); } while (0)
+
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` times 1000 divided by `n`; the result is a
+// ULLInt since 1000*t exceeds 32 bits on MSP430 after 4.29M ticks
+#define TICKS1000(t, n) ((1000*(ULLInt) (t))/(n))
+
+
+// The AEAD is built on top of the pre-output generator that grain128_cipher.c
+// provides for the target: grain_keystr32_V2 (the fastest 32-bit version on
+// x86-64) on 64-bit platforms, and the Assembler version or grain_keystr16_V2
+// on 8, 16 and 32-bit platforms. grain_keystr16_V3 is not used as it accesses
+// the LFSR and NFSR both as 16-bit and as 32-bit words, which breaks under
+// strict aliasing (e.g. GCC -O2). Defining GRAIN_KEYSTR16 (for this file and
+// grain128_cipher.c) selects the 16-bit code path on a 64-bit platform too,
+// e.g. to benchmark it on the host.
+
+#if (INTPTR_MAX > 2147483647LL) && !defined(GRAIN_KEYSTR16)
+typedef uint32_t KsWord;
+#define KSBITS 32
+extern uint32_t grain_keystr32_V2(grain_ctx *grain);
+#define grain_keystr(grain) grain_keystr32_V2((grain))
+#elif (defined(__AVR) || defined(__AVR__))
+typedef uint16_t KsWord;
+#define KSBITS 16
+extern uint16_t grain_keystr16_avr(grain_ctx *grain);
+#define grain_keystr(grain) grain_keystr16_avr((grain))
+#elif (defined(__MSP430__) || defined(__ICC430__))
+typedef uint16_t KsWord;
+#define KSBITS 16
+extern uint16_t grain_keystr16_msp(grain_ctx *grain);
+#define grain_keystr(grain) grain_keystr16_msp((grain))
+#else
+typedef uint16_t KsWord;
+#define KSBITS 16
+extern uint16_t grain_keystr16_V2(grain_ctx *grain);
+#define grain_keystr(grain) grain_keystr16_V2((grain))
+#endif
+
+// XOR of a KsWord to the most-significant KsWord of LFSR or NFSR (into which
+// the feedback is shifted); this is done on the uint32_t words of the context
+// so that LFSR and NFSR are not accessed through a uint16_t pointer
+#define XORTOP(reg, x) ((reg)[3] ^= (uint32_t) (x) << (32 - KSBITS))
+
+// Message and associated data are authenticated 64 bits at a time with the
+// word-parallel accumulator on 64-bit platforms, and one bit at a time with
+// grain_auth on 8, 16 and 32-bit platforms, where shifts of 64-bit words by a
+// variable distance are expensive. Defining GRAIN_AUTHWORD enables the word-
+// parallel accumulator on the latter too.
+
+#if (INTPTR_MAX > 2147483647LL) && !defined(GRAIN_AUTHWORD)
+#define GRAIN_AUTHWORD
+#endif
+
+
+// De-interleaving of a pre-output word: the even bits (which are used for
+// the encryption) are moved to the lower half and the odd bits (which are
+// used for the authentication) to the upper half of the word.
+
+static KsWord grain_deinterleave(KsWord y)
+{
+#if (KSBITS == 32)
+  SWAPMOVE(y, 0x22222222UL, 1);
+  SWAPMOVE(y, 0x0c0c0c0cUL, 2);
+  SWAPMOVE(y, 0x00f000f0UL, 4);
+  SWAPMOVE(y, 0x0000ff00UL, 8);
+#else
+  SWAPMOVE(y, 0x2222, 1);
+  SWAPMOVE(y, 0x0c0c, 2);
+  SWAPMOVE(y, 0x00f0, 4);
+#endif
+
+  return y;
+}
+
+
+// Returns the next eight bits of the message keystream and puts the next
+// eight bits of the authentication keystream in `za`. A new pre-output word
+// is generated when the bits of the last one have been consumed.
+
+static UChar grain_next(grain_ctx *grain, UChar *za)
+{
+  UChar ze;
+  KsWord y;
+
+  if (grain->z == 1) {
+    y = grain_deinterleave(grain_keystr(grain));
+    grain->z = (uint32_t) (y & ((1UL << (KSBITS/2)) - 1));
+    grain->z |= 1UL << (KSBITS/2);
+    grain->S = (uint64_t) (y >> (KSBITS/2));
+    grain->S |= 1ULL << (KSBITS/2);
+  }
+  ze = (UChar) grain->z;
+  *za = (UChar) grain->S;
+  grain->z >>= 8;
+  grain->S >>= 8;
+
+  return ze;
+}
+
+
+// Update of accumulator and shift register with the eight bits of byte `m`
+// (least-significant bit first): the register is added to the accumulator if
+// the message bit is 1, and the next authentication bit is shifted into the
+// register. The masking avoids a data-dependent branch.
+
+static void grain_auth(grain_ctx *grain, UChar m, UChar za)
+{
+  uint64_t A = grain->A, R = grain->R;
+  int i;
+
+  for (i = 0; i < 8; i++) {
+    A ^= R & (0 - (uint64_t) ((m >> i) & 1));
+    R = (R >> 1) | ((uint64_t) ((za >> i) & 1) << 63);
+  }
+  grain->A = A;
+  grain->R = R;
+}
+
+
+// Word-parallel update of accumulator and shift register with the `nbits`
+// (16, 32, or 64) least-significant bits of `m` and `s`, which has the same
+// effect as nbits/8 calls of grain_auth. The register followed by the `nbits`
+// authentication bits forms a window X, and message bit i adds the 64 bits
+// X[i..i+63] to the accumulator, i.e. the accumulator is updated with the 64
+// least-significant bits of the sum of m_i*(X >> i), which is a carry-less
+// multiplication. The new register is X[nbits..nbits+63]. The bits of `s`
+// above the `nbits` least-significant ones must be 0.
+
+#if defined(__PCLMUL__)
+
+// PCLMULQDQ computes X*rev(m) = sum of m_i*(X << (nbits-1-i)), whose bits
+// nbits-1 to nbits+62 are the sum of the m_i*(X >> i). X consists of R in the
+// lower and `s` in the upper 64-bit word, so two multiplications are needed.
+
+static void grain_auth_word(grain_ctx *grain, uint64_t m, uint64_t s,
+  int nbits)
+{
+  __m128i p, q, x;
+  uint64_t lo, hi;
+
+  // bit-reversal of the `nbits` least-significant bits of `m`
+  m = __builtin_bswap64(m);
+  m = ((m >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((m & 0x0f0f0f0f0f0f0f0fULL) << 4);
+  m = ((m >> 2) & 0x3333333333333333ULL) | ((m & 0x3333333333333333ULL) << 2);
+  m = ((m >> 1) & 0x5555555555555555ULL) | ((m & 0x5555555555555555ULL) << 1);
+  m >>= 64 - nbits;
+
+  x = _mm_set_epi64x((long long) s, (long long) grain->R);
+  p = _mm_clmulepi64_si128(x, _mm_cvtsi64_si128((long long) m), 0x00);
+  q = _mm_clmulepi64_si128(x, _mm_cvtsi64_si128((long long) m), 0x01);
+  lo = (uint64_t) _mm_cvtsi128_si64(p);
+  hi = (uint64_t) _mm_cvtsi128_si64(_mm_unpackhi_epi64(p, p));
+  grain->A ^= (lo >> (nbits - 1)) ^ (hi << (65 - nbits));
+  grain->A ^= (uint64_t) _mm_cvtsi128_si64(q) << (65 - nbits);
+  grain->R = (nbits == 64) ? s : (grain->R >> nbits) | (s << (64 - nbits));
+}
+
+#else
+
+// Without PCLMULQDQ, the sums X >> i with i = 0..3 are combined to a table of
+// 16 128-bit entries indexed by four message bits, so that each nibble of the
+// message costs a table look-up and a shift. The table is on the stack and so
+// small (256 bytes) that it occupies only a few cache lines.
+
+static void grain_auth_word(grain_ctx *grain, uint64_t m, uint64_t s,
+  int nbits)
+{
+  uint64_t tl[16], th[16], A;
+  int i, j;
+
+  tl[0] = th[0] = 0;
+  tl[1] = grain->R; th[1] = s;
+  for (i = 2; i < 16; i <<= 1) {
+    tl[i] = (tl[i/2] >> 1) | (th[i/2] << 63);
+    th[i] = th[i/2] >> 1;
+  }
+  for (i = 3; i < 16; i++) {
+    j = i & (0 - i);  // least-significant 1-bit of i
+    if (j == i) continue;
+    tl[i] = tl[j] ^ tl[i ^ j];
+    th[i] = th[j] ^ th[i ^ j];
+  }
+
+  A = grain->A ^ tl[m & 15];
+  for (i = 4; i < nbits; i += 4) {
+    j = (int) ((m >> i) & 15);
+    A ^= (tl[j] >> i) | (th[j] << (64 - i));
+  }
+  grain->A = A;
+  grain->R = (nbits == 64) ? s : (grain->R >> nbits) | (s << (64 - nbits));
+}
+
+#endif
+
+
+#if defined(GRAIN_AUTHWORD)
+
+// Returns the next 64 bits of the message keystream and puts the next 64
+// bits of the authentication keystream in `za`. All keystream bits of the
+// last pre-output word must have been consumed, i.e. `z` must be 1.
+
+static uint64_t grain_next64(grain_ctx *grain, uint64_t *za)
+{
+  uint64_t ze = 0, sa = 0;
+  KsWord y;
+  int i;
+
+  for (i = 0; i < 64; i += KSBITS/2) {
+    y = grain_deinterleave(grain_keystr(grain));
+    ze |= (uint64_t) (y & ((1UL << (KSBITS/2)) - 1)) << i;
+    sa |= (uint64_t) (y >> (KSBITS/2)) << i;
+  }
+  *za = sa;
+
+  return ze;
+}
+
+
+#endif
+
+
+// Authentication of data for which the message keystream is discarded, i.e.
+// the DER-encoded length and the associated data.
+
+static void grain_auth_data(grain_ctx *grain, const UChar *data, size_t len)
+{
+  size_t i = 0;
+  UChar za;
+#if defined(GRAIN_AUTHWORD)
+  uint64_t sa;
+#endif
+
+  while (i < len) {
+#if defined(GRAIN_AUTHWORD)
+    if (grain->z == 1 && len - i >= 8) {
+      grain_next64(grain, &sa);
+      grain_auth_word(grain, LOAD64(&data[i]), sa, 64);
+      i += 8;
+      continue;
+    }
+#endif
+    grain_next(grain, &za);
+    grain_auth(grain, data[i], za);
+    i++;
+  }
+}
+
+
+// Initialization of the streaming API: loads key and nonce into the NFSR and
+// LFSR, clocks the pre-output generator 320 times with feedback of the pre-
+// output and 64 times with feedback of the pre-output and the key, and then
+// initializes accumulator and shift register with the next 128 pre-output
+// bits. Since the length of the associated data is encoded (in DER format) in
+// front of it, the associated data has to be passed in one piece here.
+
+void grain_aead_init(grain_ctx *grain, const UChar *key, const UChar *npub,
+  const UChar *ad, size_t adlen)
+{
+  KsWord kw[128/KSBITS], y;
+  UChar der[9], t;
+  size_t i, derlen = 1;
+
+  memcpy(kw, key, KEYSZ);
+  memcpy(grain->nfsr, key, KEYSZ);
+  memcpy(grain->lfsr, npub, NPUBSZ);
+  grain->lfsr[3] = 0x7fffffffUL;
+
+  for (i = 0; i < INITCLKS; i += KSBITS) {
+    y = grain_keystr(grain);
+    XORTOP(grain->lfsr, y);
+    XORTOP(grain->nfsr, y);
+    if (i < INITCLKS - 64) continue;
+    // re-introduction of the key: bits 64-127 into the LFSR, bits 0-63 into
+    // the NFSR
+    XORTOP(grain->lfsr, kw[(i - (INITCLKS - 128))/KSBITS]);
+    XORTOP(grain->nfsr, kw[(i - (INITCLKS - 64))/KSBITS]);
+  }
+
+  grain->A = grain->R = 0;
+  for (i = 0; i < 64; i += KSBITS) {
+    grain->A |= (uint64_t) grain_keystr(grain) << i;
+  }
+  for (i = 0; i < 64; i += KSBITS) {
+    grain->R |= (uint64_t) grain_keystr(grain) << i;
+  }
+  grain->z = 1;
+  grain->S = 1;
+
+  // DER encoding of the length of the associated data: a single byte if the
+  // length is below 128, otherwise 0x80 plus the number of length-bytes
+  // followed by the length in big-endian format
+  der[0] = (UChar) adlen;
+  if (adlen >= 128) {
+    for (i = adlen; i > 0; i >>= 8) der[derlen++] = (UChar) i;
+    der[0] = (UChar) (0x80 | (derlen - 1));
+    for (i = 1; i < (derlen + 1)/2; i++) {
+      t = der[i]; der[i] = der[derlen-i]; der[derlen-i] = t;
+    }
+  }
+
+  grain_auth_data(grain, der, derlen);
+  grain_auth_data(grain, ad, adlen);
+}
+
+
+// Encryption of a message, which can be split up into an arbitrary number of
+// chunks of arbitrary length. Ciphertext and plaintext may be the same buffer.
+
+void grain_aead_enc_update(grain_ctx *grain, UChar *c, const UChar *m,
+  size_t mlen)
+{
+  UChar ze, za, mi;
+  size_t i = 0;
+#if defined(GRAIN_AUTHWORD)
+  uint64_t zw, sa, mw;
+#endif
+
+  while (i < mlen) {
+#if defined(GRAIN_AUTHWORD)
+    // blocks of 8 bytes once the last pre-output word has been consumed
+    if (grain->z == 1 && mlen - i >= 8) {
+      zw = grain_next64(grain, &sa);
+      mw = LOAD64(&m[i]);
+      zw ^= mw;
+      STORE64(&c[i], zw);
+      grain_auth_word(grain, mw, sa, 64);
+      i += 8;
+      continue;
+    }
+#endif
+    ze = grain_next(grain, &za);
+    mi = m[i];
+    c[i] = mi ^ ze;
+    grain_auth(grain, mi, za);
+    i++;
+  }
+}
+
+
+// Decryption of a ciphertext, which can be split up into an arbitrary number
+// of chunks of arbitrary length. Plaintext and ciphertext may be the same
+// buffer. The plaintext must not be used before grain_aead_dec_final has
+// verified the tag.
+
+void grain_aead_dec_update(grain_ctx *grain, UChar *m, const UChar *c,
+  size_t clen)
+{
+  UChar ze, za, mi;
+  size_t i = 0;
+#if defined(GRAIN_AUTHWORD)
+  uint64_t zw, sa, mw;
+#endif
+
+  while (i < clen) {
+#if defined(GRAIN_AUTHWORD)
+    // blocks of 8 bytes once the last pre-output word has been consumed
+    if (grain->z == 1 && clen - i >= 8) {
+      zw = grain_next64(grain, &sa);
+      mw = LOAD64(&c[i]) ^ zw;
+      STORE64(&m[i], mw);
+      grain_auth_word(grain, mw, sa, 64);
+      i += 8;
+      continue;
+    }
+#endif
+    ze = grain_next(grain, &za);
+    mi = c[i] ^ ze;
+    m[i] = mi;
+    grain_auth(grain, mi, za);
+    i++;
+  }
+}
+
+
+// Finalization: the padding bit (which is always 1) adds the register to the
+// accumulator, whose content is the 64-bit tag.
+
+void grain_aead_enc_final(grain_ctx *grain, UChar *tag)
+{
+  uint64_t A = grain->A ^ grain->R;
+  int i;
+
+  for (i = 0; i < TAGSZ; i++) tag[i] = (UChar) (A >> 8*i);
+}
+
+
+// Finalization of the decryption. The tag is compared in constant time; the
+// return value is 0 if the tag is valid and -1 otherwise.
+
+int grain_aead_dec_final(grain_ctx *grain, const UChar *tag)
+{
+  UChar ref[TAGSZ], diff = 0;
+  int i;
+
+  grain_aead_enc_final(grain, ref);
+  for (i = 0; i < TAGSZ; i++) diff |= ref[i] ^ tag[i];
+
+  return -(int) ((diff + 0xff) >> 8);
+}
+
+
+// One-shot encryption of a short packet. Ciphertext and plaintext may be the
+// same buffer. In contrast to the NIST API, the tag is written into a buffer
+// of its own so that `c` does not have to be larger than `m`.
+
+void grain_aead_encrypt(UChar *c, UChar *tag, const UChar *m, size_t mlen,
+  const UChar *ad, size_t adlen, const UChar *npub, const UChar *key)
+{
+  grain_ctx grain;
+
+  grain_aead_init(&grain, key, npub, ad, adlen);
+  grain_aead_enc_update(&grain, c, m, mlen);
+  grain_aead_enc_final(&grain, tag);
+}
+
+
+// One-shot decryption of a short packet. If the tag is invalid, the output
+// buffer is cleared and -1 is returned.
+
+int grain_aead_decrypt(UChar *m, const UChar *c, size_t clen,
+  const UChar *tag, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key)
+{
+  grain_ctx grain;
+  int res;
+
+  grain_aead_init(&grain, key, npub, ad, adlen);
+  grain_aead_dec_update(&grain, m, c, clen);
+  res = grain_aead_dec_final(&grain, tag);
+  if (res != 0) memset(m, 0, clen);
+
+  return res;
+}
+
+
+// Print a byte-array in Hex format (the output is limited to the first 64
+// bytes of the byte-array).
+
+static void print_bytes(const char* str, const UChar *bytearray, size_t len)
+{
+  UChar buffer[148], byte;
+  size_t i, j, slen = 0;
+
+  if (str != NULL) {
+    slen = MIN(16, strlen(str));
+    memcpy(buffer, str, slen);
+  }
+
+  j = slen;
+  for (i = 0; i < MIN(64, len); i++) {
+    byte = bytearray[i] >> 4;
+    // replace 87 by 55 to get uppercase letters
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+    byte = bytearray[i] & 0xf;
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+  }
+  if (len > 64) {
+    buffer[j] = buffer[j+1] = buffer[j+2] = '.';
+    j += 3;
+  }
+  buffer[j] = '\0';
+
+  printf("%s\n", buffer);
+}
+
+
+// Simple test function for the Grain-128AEADv2 AEAD. The 1st test uses an
+// empty message and empty associated data, the 2nd test encrypts a 41-byte
+// message (in place) in chunks of 1, 7, and 33 bytes with 130 bytes of
+// associated data (i.e. a DER length of two bytes) and decrypts it with the
+// one-shot function, the 3rd test checks that a tampered ciphertext is
+// rejected, the 4th test encrypts and decrypts 49*49 messages, and the 5th
+// test compares the word-parallel accumulator with the bit-serial one for
+// 16, 32, and 64 bits per step and pseudo-random inputs.
+
+void grain128_test_aead(void)
+{
+  UChar key[KEYSZ], npub[NPUBSZ], ad[130], msg[48], buf[48], tag[TAGSZ];
+  UChar sum[TAGSZ];
+  grain_ctx grain, ref;
+  uint64_t m, sa, x = 0x0123456789abcdefULL;
+  int i, j, res, err = 0;
+
+  for (i = 0; i < KEYSZ; i++) key[i] = (UChar) i;
+  for (i = 0; i < NPUBSZ; i++) npub[i] = (UChar) i;
+  for (i = 0; i < 130; i++) ad[i] = (UChar) i;
+  for (i = 0; i < 48; i++) msg[i] = (UChar) i;
+  memset(buf, 0, sizeof(buf));
+
+  // 1st test: empty message and empty associated data
+
+  printf("Test 1 - C99 implementation:\n");
+  grain_aead_encrypt(buf, tag, buf, 0, ad, 0, npub, key);
+  print_bytes("Tag: ", tag, TAGSZ);
+
+  // 2nd test: in-place encryption in chunks and one-shot decryption
+
+  printf("Test 2 - C99 implementation:\n");
+  for (i = 0; i < 41; i++) buf[i] = (UChar) i;
+  grain_aead_init(&grain, key, npub, ad, 130);
+  grain_aead_enc_update(&grain, buf, buf, 1);
+  grain_aead_enc_update(&grain, buf + 1, buf + 1, 7);
+  grain_aead_enc_update(&grain, buf + 8, buf + 8, 33);
+  grain_aead_enc_final(&grain, tag);
+  print_bytes("CT:  ", buf, 41);
+  print_bytes("Tag: ", tag, TAGSZ);
+  res = grain_aead_decrypt(buf, buf, 41, tag, ad, 130, npub, key);
+  print_bytes("PT:  ", buf, 41);
+  printf("Verification: %s\n", (res == 0) ? "ok" : "failed");
+
+  // 3rd test: a flipped bit in the ciphertext must be detected
+
+  printf("Test 3 - C99 implementation:\n");
+  grain_aead_encrypt(buf, tag, buf, 41, ad, 32, npub, key);
+  buf[40] ^= 0x01;
+  res = grain_aead_decrypt(buf, buf, 41, tag, ad, 32, npub, key);
+  printf("Verification: %s\n", (res == 0) ? "ok" : "failed");
+  print_bytes("PT:  ", buf, 41);
+
+  // 4th test: 49*49 messages with different lengths
+
+  printf("Test 4 - C99 implementation:\n");
+  memset(sum, 0, sizeof(sum));
+  for (i = 0; i <= 48; i++) {
+    for (j = 0; j <= 48; j++) {
+      grain_aead_encrypt(buf, tag, msg, i, ad, j, npub, key);
+      for (res = 0; res < TAGSZ; res++) sum[res] ^= tag[res];
+      res = grain_aead_decrypt(buf, buf, i, tag, ad, j, npub, key);
+      if (res != 0 || memcmp(buf, msg, i) != 0) err++;
+    }
+  }
+  print_bytes("Sum: ", sum, TAGSZ);
+  printf("Mismatches: %i\n", err);
+
+  // 5th test: word-parallel vs. bit-serial accumulator (with inputs from a
+  // xorshift generator)
+
+  printf("Test 5 - C99 implementation:\n");
+  err = 0;
+  for (i = 0; i < 3000; i++) {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17; ref.A = grain.A = x;
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17; ref.R = grain.R = x;
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17; m = x;
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17; sa = x;
+    res = 16 << (i % 3);  // 16, 32, or 64 bits
+    if (res < 64) sa &= (1ULL << res) - 1;
+    grain_auth_word(&grain, m, sa, res);
+    for (j = 0; j < res; j += 8) {
+      grain_auth(&ref, (UChar) (m >> j), (UChar) (sa >> j));
+    }
+    if (grain.A != ref.A || grain.R != ref.R) err++;
+  }
+  printf("Mismatches: %i\n", err);
+
+  // Expected result
+  // ---------------
+  // Test 1 - C99 implementation:
+  // Tag: d51fd5d16177b434
+  // Test 2 - C99 implementation:
+  // CT:  466ce36b3ee89c3c347d7c459d314b0c31b017abff852715e911b0157430bb3a52160b64a2a0806967
+  // Tag: 45e251cb5f20ada2
+  // PT:  000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728
+  // Verification: ok
+  // Test 3 - C99 implementation:
+  // Verification: failed
+  // PT:  0000000000000000000000000000000000000000000000000000000000000000000000000000000000
+  // Test 4 - C99 implementation:
+  // Sum: 171c67a430402a37
+  // Mismatches: 0
+  // Test 5 - C99 implementation:
+  // Mismatches: 0
+}
+
+
+// Benchmark of the encryption of messages of 16, 64, 256, and 1024 bytes
+// without associated data; the results are the number of CYCLES() ticks per
+// encryption and per byte times 1000. The line for the empty message is the
+// cost of the initialization (512 clocks) and the finalization.
+
+void grain128_bench_aead(long iter)
+{
+  static const size_t len[5] = { 0, 16, 64, 256, 1024 };
+  static UChar buf[1024];
+  UChar key[KEYSZ], npub[NPUBSZ], tag[TAGSZ];
+  unsigned long start, t;
+  long n;
+  int i;
+
+  for (i = 0; i < KEYSZ; i++) key[i] = (UChar) i;
+  for (i = 0; i < NPUBSZ; i++) npub[i] = (UChar) i;
+  for (i = 0; i < 1024; i++) buf[i] = (UChar) i;
+
+  printf("%i-bit pre-output generator\n", KSBITS);
+  for (i = 0; i < 5; i++) {
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      grain_aead_encrypt(buf, tag, buf, len[i], NULL, 0, npub, key);
+    }
+    t = CYCLES() - start;
+    printf("%4i bytes: %llu (%llu per byte)\n", (int) len[i],
+      TICKS1000(t, iter), TICKS1000(t, (ULLInt) iter*MAX(len[i], 1)));
+  }
+}
+
+
+// Benchmark of the accumulator alone: the bit-serial version and the word-
+// parallel version with 16, 32, and 64 bits per step authenticate a 1024-byte
+// message; the results are the number of CYCLES() ticks per byte times 1000.
+
+void grain128_bench_auth(long iter)
+{
+  static UChar buf[1024];
+  uint64_t m, sa, mask;
+  grain_ctx grain;
+  unsigned long start, t;
+  long n;
+  int i, j, nbits;
+
+  for (i = 0; i < 1024; i++) buf[i] = (UChar) (i*i + i);
+  grain.A = 0x0123456789abcdefULL;
+  grain.R = 0xfedcba9876543210ULL;
+
+  start = CYCLES();
+  for (n = 0; n < iter; n++) {
+    for (i = 0; i < 1024; i++) grain_auth(&grain, buf[i], buf[1023-i]);
+  }
+  t = CYCLES() - start;
+  printf("bit-serial: %llu per byte\n", TICKS1000(t, (ULLInt) iter*1024));
+
+  for (nbits = 16; nbits <= 64; nbits <<= 1) {
+    mask = (nbits == 64) ? ~0ULL : (1ULL << nbits) - 1;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      for (i = 0; i < 1024; i += 8) {
+        m = LOAD64(&buf[i]);
+        sa = LOAD64(&buf[1016-i]);
+        for (j = 0; j < 64; j += nbits) {
+          grain_auth_word(&grain, m >> j, (sa >> j) & mask, nbits);
+        }
+      }
+    }
+    t = CYCLES() - start;
+    printf("%i-bit words: %llu per byte\n", nbits,
+      TICKS1000(t, (ULLInt) iter*1024));
+  }
+  // the accumulator is printed so that the loops are not optimized away
+  print_bytes("A: ", (UChar *) &grain.A, 8);
+}
@@ -112,8 +112,16 @@ static void print_grain(const grain_ctx *grain)
 }
 
 
+// The 16-bit implementation can also be selected on a 64-bit platform by
+// defining GRAIN_KEYSTR16, e.g. to test and benchmark it on the host.
+
+#if (INTPTR_MAX > 2147483647LL) && !defined(GRAIN_KEYSTR16)
+#define GRAIN_KEYSTR32
+#endif
+
+
 ///////////////////////////////////////////////////////////////////////////////
-#if (INTPTR_MAX > 2147483647LL) ///// IMPLEMENTATION FOR 64-BIT PLATFORMS /////
+#if defined(GRAIN_KEYSTR32) /////// IMPLEMENTATION FOR 64-BIT PLATFORMS ///////
 ///////////////////////////////////////////////////////////////////////////////
 
 
@@ -461,7 +469,7 @@ uint16_t grain_keystr16_V1(grain_ctx *grain)
   
   y  = (uint16_t) ((L32( 1) >> 5) & (L32( 2) >> 4));
   y ^= (uint16_t) ((L32( 7) >> 4) & (L32( 9) >> 7));
-  y ^= (uint16_t) ((N32(11) >> 7) & (L32( 5) >> 2) ^ (N32(11) >> 1));
+  y ^= (uint16_t) (((N32(11) >> 7) & (L32( 5) >> 2)) ^ (N32(11) >> 1));
   y ^= (uint16_t) ((N32( 1) >> 4) & (N32(11) >> 7) & (L32(11) >> 6));
   y ^= (uint16_t) ((N32( 1) >> 4) & L32( 1));
   y ^= (uint16_t) ((L32(11) >> 5) ^ (N32( 0) >> 2) ^ (N32( 1) >> 7));
@@ -480,7 +488,7 @@ uint16_t grain_keystr16_V1(grain_ctx *grain)
   nn ^= (uint16_t) ((N32( 2) >> 6) & N32( 3) & (N32( 3) >> 1));
   nn ^= (uint16_t) ((N32( 8) >> 6) & (N32( 9) >> 6) & (N32(10) >> 2));
   
-  memcpy(((uint16_t*) grain->lfsr), ((uint16_t*) grain->lfsr) + 1, 30);
+  memmove(((uint16_t*) grain->lfsr), ((uint16_t*) grain->lfsr) + 1, 30);
   ((uint16_t*) grain->lfsr)[7] = ln;
   ((uint16_t*) grain->nfsr)[7] = nn;
   
@@ -0,0 +1,675 @@
+///////////////////////////////////////////////////////////////////////////////
+// isap_aead.c: C99 implementation and unit-test of ISAP-A-128(A) AEAD.      //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+typedef union {
+  uint64_t x[5];
+  uint32_t w[5][2];
+  uint8_t b[5][8];
+} State;
+
+
+// variants
+#define ISAPA128A 0  // sH = 12, sB = 1, sE = 6, sK = 12
+#define ISAPA128  1  // sH = 12, sB = 12, sE = 12, sK = 12
+
+// initialization vectors without the 8-bit flag in the most-significant
+// byte, i.e. k || rH || rB || sH || sB || sE || sK
+#define IVA128A 0x008040010c01060cULL
+#define IVA128  0x008040010c0c0c0cULL
+
+// flags of the initialization vectors of the MAC (IV_A), the re-keying for
+// the MAC (IV_KA), and the re-keying for the encryption (IV_KE)
+#define FLAG_A  0x0100000000000000ULL
+#define FLAG_KA 0x0200000000000000ULL
+#define FLAG_KE 0x0300000000000000ULL
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// load/store of a big-endian 64-bit word from/to an unaligned byte-array
+#define LOAD64(p) (((uint64_t) (p)[0] << 56) | ((uint64_t) (p)[1] << 48) | \
+  ((uint64_t) (p)[2] << 40) | ((uint64_t) (p)[3] << 32) | \
+  ((uint64_t) (p)[4] << 24) | ((uint64_t) (p)[5] << 16) | \
+  ((uint64_t) (p)[6] <<  8) | ((uint64_t) (p)[7]))
+#define STORE64(p, x) do { (p)[0] = (uint8_t) ((x) >> 56); \
+  (p)[1] = (uint8_t) ((x) >> 48); (p)[2] = (uint8_t) ((x) >> 40); \
+  (p)[3] = (uint8_t) ((x) >> 32); (p)[4] = (uint8_t) ((x) >> 24); \
+  (p)[5] = (uint8_t) ((x) >> 16); (p)[6] = (uint8_t) ((x) >>  8); \
+  (p)[7] = (uint8_t) (x); } while (0)
+
+// i-th byte of the rate-word x[0] in big-endian order (ISAP is specified
+// big-endian, the host is little-endian like MSP430, AVR and x86)
+#define SBYTE(s, i) ((s)->b[0][7 ^ (i)])
+
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` times 1000 divided by `n`; the result is a
+// ULLInt since 1000*t exceeds 32 bits on MSP430 after 4.29M ticks
+#define TICKS1000(t, n) ((1000*(ULLInt) (t))/(n))
+
+// ratio of the tick counts `a` and `b` in %, or 0 if `b` is 0 (which can
+// happen on a host due to the resolution of clock())
+#define PERCENT(a, b) ((b) ? (100*(ULLInt) (a))/(b) : 0ULL)
+
+
+extern void isap_c99_pn(State *s, int nr);
+extern void isap_c99_rk(State *s, const UChar *y, int nrb);
+extern void isap_c99_x2(State *s, const int *nr, int n);
+#if defined(__AVX512VL__)
+extern void isap_sse2_x2(State *s, const int *nr, int n);
+#endif
+
+#if (defined(__AVR) || defined(__AVR__))
+extern void isap_avr(State *s, int nr);
+#define isap_asm(s, nr) isap_avr((s), (nr))
+#define ISAP_ASSEMBLER
+#endif
+
+#if (defined(__MSP430__) || defined(__ICC430__))
+extern void isap_msp(State *s, int nr);
+extern void isap_msp_rk(State *s, const UChar *y, int nrb);
+#define isap_asm(s, nr) isap_msp((s), (nr))
+#define isap_asm_rk(s, y, nrb) isap_msp_rk((s), (y), (nrb))
+#define ISAP_ASSEMBLER
+#endif
+
+// the mode uses the Assembler permutation when available, otherwise the
+// C99 permutation from isap_perm.c (which dispatches the round-counts 12, 6,
+// and 1 to unrolled versions of isap_c99_V3)
+#if defined(ISAP_ASSEMBLER)
+#define ISAP_PERM(s, nr) isap_asm((s), (nr))
+#else
+#define ISAP_PERM(s, nr) isap_c99_pn((s), (nr))
+#endif
+
+// the bit-absorption of ISAP_RK uses a fused function (which loads and stores
+// the state only once) when available, i.e. on MSP430 and in C99, otherwise a
+// loop that calls the permutation for each bit
+#if defined(isap_asm_rk)
+#define ISAP_RK(s, y, nrb) isap_asm_rk((s), (y), (nrb))
+#elif !defined(ISAP_ASSEMBLER)
+#define ISAP_RK(s, y, nrb) isap_c99_rk((s), (y), (nrb))
+#endif
+
+// two-lane permutation of the interleaved encryption; the SIMD version is
+// only used when the 64-bit rotations are single instructions (AVX-512VL)
+#if defined(__AVX512VL__)
+#define ISAP_PERM_X2(s, nr, n) isap_sse2_x2((s), (nr), (n))
+#else
+#define ISAP_PERM_X2(s, nr, n) isap_c99_x2((s), (nr), (n))
+#endif
+
+
+// Re-keying function ISAP_RK: the key and the initialization vector `iv` are
+// permuted with sK rounds, then the 128-bit value `y` is absorbed bit by bit
+// (with sB rounds after every bit but the last and sK rounds after the last
+// bit). The session key is in the first words of the state, namely x[0] and
+// x[1] for the MAC and x[0]-x[2] for the encryption.
+
+static void isap_rk(State *s, const UChar *key, uint64_t iv, const UChar *y,
+  int nrb)
+{
+#if !defined(ISAP_RK)
+  int i;
+#endif
+
+  s->x[0] = LOAD64(key);
+  s->x[1] = LOAD64(key + 8);
+  s->x[2] = iv;
+  s->x[3] = s->x[4] = 0;
+  ISAP_PERM(s, 12);
+#if defined(ISAP_RK)
+  ISAP_RK(s, y, nrb);
+#else
+  for (i = 0; i < 127; i++) {
+    s->x[0] ^= ((uint64_t) (y[i >> 3] >> (7 - (i & 7)))) << 63;
+    ISAP_PERM(s, nrb);
+  }
+  s->x[0] ^= ((uint64_t) y[15]) << 63;
+  ISAP_PERM(s, 12);
+#endif
+}
+
+
+// Absorption of the associated data or the ciphertext into the MAC state
+// with a rate of 8 bytes and 12 rounds. The data is always padded, i.e. an
+// empty input or an input whose length is a multiple of 8 yields an extra
+// block.
+
+static void isap_absorb(State *s, const UChar *in, size_t inlen)
+{
+  size_t i;
+
+  while (inlen >= 8) {
+    s->x[0] ^= LOAD64(in);
+    ISAP_PERM(s, 12);
+    in += 8;
+    inlen -= 8;
+  }
+  for (i = 0; i < inlen; i++) SBYTE(s, i) ^= in[i];
+  SBYTE(s, inlen) ^= 0x80;
+  ISAP_PERM(s, 12);
+}
+
+
+// Computation of the 128-bit tag over the associated data and the ciphertext
+// (ISAP_MAC). The nonce and IV_A are permuted, the associated data and the
+// ciphertext are absorbed (with a domain separation in between), and x[0]
+// and x[1] are replaced by the session key derived with ISAP_RK from the
+// first 128 bits of the state before the final permutation.
+
+static void isap_mac(UChar *tag, const UChar *c, size_t clen,
+  const UChar *ad, size_t adlen, const UChar *npub, const UChar *key,
+  int variant)
+{
+  uint64_t iv = (variant == ISAPA128) ? IVA128 : IVA128A;
+  int nrb = (variant == ISAPA128) ? 12 : 1;
+  UChar y[16];
+  State s, t;
+
+  s.x[0] = LOAD64(npub);
+  s.x[1] = LOAD64(npub + 8);
+  s.x[2] = FLAG_A | iv;
+  s.x[3] = s.x[4] = 0;
+  ISAP_PERM(&s, 12);
+  isap_absorb(&s, ad, adlen);
+  s.x[4] ^= 1;
+  isap_absorb(&s, c, clen);
+  STORE64(y, s.x[0]);
+  STORE64(y + 8, s.x[1]);
+  isap_rk(&t, key, FLAG_KA | iv, y, nrb);
+  s.x[0] = t.x[0];
+  s.x[1] = t.x[1];
+  ISAP_PERM(&s, 12);
+  STORE64(tag, s.x[0]);
+  STORE64(tag + 8, s.x[1]);
+}
+
+
+// Encryption or decryption (ISAP_ENC): the 192-bit session key derived with
+// ISAP_RK from the nonce and the nonce form the state, which is permuted
+// with sE rounds before each 8-byte block of the key stream is extracted.
+// The output `out` can be the same buffer as the input `in`.
+
+static void isap_enc(UChar *out, const UChar *in, size_t len,
+  const UChar *npub, const UChar *key, int variant)
+{
+  uint64_t iv = (variant == ISAPA128) ? IVA128 : IVA128A;
+  int nrb = (variant == ISAPA128) ? 12 : 1;
+  int nre = (variant == ISAPA128) ? 12 : 6;
+  uint64_t w;
+  State s;
+  size_t i;
+
+  if (len == 0) return;
+  isap_rk(&s, key, FLAG_KE | iv, npub, nrb);
+  s.x[3] = LOAD64(npub);
+  s.x[4] = LOAD64(npub + 8);
+  while (len >= 8) {
+    ISAP_PERM(&s, nre);
+    w = LOAD64(in) ^ s.x[0];
+    STORE64(out, w);
+    in += 8;
+    out += 8;
+    len -= 8;
+  }
+  if (len > 0) {
+    ISAP_PERM(&s, nre);
+    for (i = 0; i < len; i++) out[i] = in[i] ^ SBYTE(&s, i);
+  }
+}
+
+
+// One-shot encryption; the `variant` is either ISAPA128A or ISAPA128. The
+// ciphertext `c` can be the same buffer as the plaintext `m`.
+
+void isap_aead_encrypt(UChar *c, UChar *tag, const UChar *m, size_t mlen,
+  const UChar *ad, size_t adlen, const UChar *npub, const UChar *key,
+  int variant)
+{
+  isap_enc(c, m, mlen, npub, key, variant);
+  isap_mac(tag, c, mlen, ad, adlen, npub, key, variant);
+}
+
+
+// One-shot decryption. ISAP is an encrypt-then-MAC scheme, so the tag can be
+// verified before anything is decrypted: the MAC over the ciphertext is
+// computed and compared (in constant time) first, and only if the tag is
+// valid, the key stream is generated and the plaintext is written to `m`.
+// A forgery is rejected with -1 and `m` is not modified at all, i.e. neither
+// the re-keying nor the key stream of the encryption is executed.
+
+int isap_aead_decrypt(UChar *m, const UChar *c, size_t clen,
+  const UChar *tag, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant)
+{
+  UChar t[16], diff = 0;
+  int i;
+
+  isap_mac(t, c, clen, ad, adlen, npub, key, variant);
+  for (i = 0; i < 16; i++) diff |= t[i] ^ tag[i];
+  if (diff != 0) return -1;
+  isap_enc(m, c, clen, npub, key, variant);
+
+  return 0;
+}
+
+
+// Context of the interleaved encryption. Lane 0 is the state of ISAP_ENC and
+// lane 1 the state of ISAP_MAC; left[i] is the number of rounds of the
+// current permutation of lane i that still have to be executed (0 means the
+// lane is idle, i.e. it waits for ciphertext or is finished).
+
+typedef struct {
+  State s[2];
+  int left[2];
+  int phase[2];
+  const UChar *m, *ad, *npub, *key;
+  UChar *c;
+  size_t mlen, adlen, cpos, epos, apos;
+  uint64_t iv;
+  int nrb, nre, bit;
+} IsapX2;
+
+// phases of the two lanes
+#define X2_START 0
+#define X2_RK    1  // lane 0: absorption of the nonce (ISAP_RK)
+#define X2_KS    2  // lane 0: generation of the key stream
+#define X2_AD    1  // lane 1: absorption of the associated data
+#define X2_ADEND 2  // lane 1: domain separation
+#define X2_CT    3  // lane 1: absorption of the ciphertext
+#define X2_DONE  4
+
+
+// Lane 0 (ISAP_ENC): the output of the finished permutation is processed and
+// the input of the next permutation is prepared. ISAP_RK is executed bit by
+// bit, i.e. each bit is a permutation with sB (or sK) rounds.
+
+static void isap_x2_enc(IsapX2 *x)
+{
+  State *s = &x->s[0];
+  size_t i, len;
+  uint64_t w;
+
+  switch (x->phase[0]) {
+    case X2_START:
+      s->x[0] = LOAD64(x->key);
+      s->x[1] = LOAD64(x->key + 8);
+      s->x[2] = FLAG_KE | x->iv;
+      s->x[3] = s->x[4] = 0;
+      x->left[0] = 12;
+      x->phase[0] = X2_RK;
+      x->bit = 0;
+      break;
+    case X2_RK:
+      if (x->bit < 128) {
+        s->x[0] ^= ((uint64_t) (x->npub[x->bit >> 3] >>
+          (7 - (x->bit & 7)))) << 63;
+        x->left[0] = (x->bit == 127) ? 12 : x->nrb;
+        x->bit++;
+        break;
+      }
+      s->x[3] = LOAD64(x->npub);
+      s->x[4] = LOAD64(x->npub + 8);
+      x->left[0] = x->nre;
+      x->phase[0] = X2_KS;
+      break;
+    case X2_KS:
+      len = MIN(8, x->mlen - x->cpos);
+      if (len == 8) {
+        w = LOAD64(x->m + x->cpos) ^ s->x[0];
+        STORE64(x->c + x->cpos, w);
+      } else {
+        for (i = 0; i < len; i++) x->c[x->cpos + i] = x->m[x->cpos + i] ^
+          SBYTE(s, i);
+      }
+      x->cpos += len;
+      if (x->cpos < x->mlen) x->left[0] = x->nre;
+      else x->phase[0] = X2_DONE;
+      break;
+  }
+}
+
+
+// Lane 1 (ISAP_MAC up to ISAP_RK): the associated data and the ciphertext
+// are absorbed as in isap_absorb, but a block of ciphertext is only absorbed
+// when lane 0 has produced it.
+
+static void isap_x2_mac(IsapX2 *x)
+{
+  State *s = &x->s[1];
+  size_t i, len;
+
+  switch (x->phase[1]) {
+    case X2_START:
+      s->x[0] = LOAD64(x->npub);
+      s->x[1] = LOAD64(x->npub + 8);
+      s->x[2] = FLAG_A | x->iv;
+      s->x[3] = s->x[4] = 0;
+      x->left[1] = 12;
+      x->phase[1] = X2_AD;
+      break;
+    case X2_AD:
+      len = x->adlen - x->apos;
+      if (len >= 8) {
+        s->x[0] ^= LOAD64(x->ad + x->apos);
+        x->apos += 8;
+      } else {
+        for (i = 0; i < len; i++) SBYTE(s, i) ^= x->ad[x->apos + i];
+        SBYTE(s, len) ^= 0x80;
+        x->phase[1] = X2_ADEND;
+      }
+      x->left[1] = 12;
+      break;
+    case X2_ADEND:
+      s->x[4] ^= 1;
+      x->phase[1] = X2_CT;
+      // fall through
+    case X2_CT:
+      len = x->mlen - x->epos;
+      if (len >= 8) {
+        if (x->cpos < x->epos + 8) break;  // wait for lane 0
+        s->x[0] ^= LOAD64(x->c + x->epos);
+        x->epos += 8;
+      } else {
+        if (x->cpos < x->mlen) break;  // wait for lane 0
+        for (i = 0; i < len; i++) SBYTE(s, i) ^= x->c[x->epos + i];
+        SBYTE(s, len) ^= 0x80;
+        x->phase[1] = X2_DONE;
+      }
+      x->left[1] = 12;
+      break;
+  }
+}
+
+
+// Encryption with interleaved execution of ISAP_ENC and ISAP_MAC. The two
+// states are permuted together with the two-lane permutation; the number of
+// rounds of each call is the minimum of the remaining rounds of both lanes,
+// i.e. in ISAP-A-128A two 6-round permutations of the encryption are paired
+// with one 12-round permutation of the MAC. The ciphertext and the tag are
+// bit-identical to isap_aead_encrypt; ISAP_RK of the MAC (which depends on
+// all of the ciphertext) and the final permutation are executed afterwards.
+
+void isap_aead_encrypt_x2(UChar *c, UChar *tag, const UChar *m, size_t mlen,
+  const UChar *ad, size_t adlen, const UChar *npub, const UChar *key,
+  int variant)
+{
+  IsapX2 x;
+  UChar y[16];
+  State t;
+  int n;
+
+  x.m = m; x.c = c; x.mlen = mlen;
+  x.ad = ad; x.adlen = adlen;
+  x.npub = npub; x.key = key;
+  x.iv = (variant == ISAPA128) ? IVA128 : IVA128A;
+  x.nrb = (variant == ISAPA128) ? 12 : 1;
+  x.nre = (variant == ISAPA128) ? 12 : 6;
+  x.cpos = x.epos = x.apos = 0;
+  x.left[0] = x.left[1] = 0;
+  x.phase[0] = (mlen > 0) ? X2_START : X2_DONE;
+  x.phase[1] = X2_START;
+
+  for (;;) {
+    if (x.left[0] == 0) isap_x2_enc(&x);
+    if (x.left[1] == 0) isap_x2_mac(&x);
+    if (x.left[0] > 0 && x.left[1] > 0) {
+      n = MIN(x.left[0], x.left[1]);
+      ISAP_PERM_X2(x.s, x.left, n);
+      x.left[0] -= n;
+      x.left[1] -= n;
+    } else if (x.left[0] > 0) {
+      ISAP_PERM(&x.s[0], x.left[0]);
+      x.left[0] = 0;
+    } else if (x.left[1] > 0) {
+      ISAP_PERM(&x.s[1], x.left[1]);
+      x.left[1] = 0;
+    } else {
+      break;
+    }
+  }
+
+  STORE64(y, x.s[1].x[0]);
+  STORE64(y + 8, x.s[1].x[1]);
+  isap_rk(&t, key, FLAG_KA | x.iv, y, x.nrb);
+  x.s[1].x[0] = t.x[0];
+  x.s[1].x[1] = t.x[1];
+  ISAP_PERM(&x.s[1], 12);
+  STORE64(tag, x.s[1].x[0]);
+  STORE64(tag + 8, x.s[1].x[1]);
+}
+
+
+// Print a byte-array in Hex format (the output is limited to the first 64
+// bytes of the byte-array).
+
+static void print_bytes(const char* str, const UChar *bytearray, size_t len)
+{
+  UChar buffer[148], byte;
+  size_t i, j, slen = 0;
+
+  if (str != NULL) {
+    slen = MIN(16, strlen(str));
+    memcpy(buffer, str, slen);
+  }
+
+  j = slen;
+  for (i = 0; i < MIN(64, len); i++) {
+    byte = bytearray[i] >> 4;
+    // replace 87 by 55 to get uppercase letters
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+    byte = bytearray[i] & 0xf;
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+  }
+  if (len > 64) {
+    buffer[j] = buffer[j+1] = buffer[j+2] = '.';
+    j += 3;
+  }
+  buffer[j] = '\0';
+
+  printf("%s\n", buffer);
+}
+
+
+// Simple test function for ISAP-A-128A and ISAP-A-128. The 1st test uses the
+// key and nonce of the NIST KAT files with empty message and associated
+// data, the 2nd test encrypts a 41-byte message with 32 bytes of associated
+// data (in place) and decrypts it again, the 3rd test checks that a
+// tampered ciphertext is rejected without touching the output buffer, and
+// the 4th test compares the interleaved encryption with the sequential one
+// for all message lengths from 0 to 64 bytes and several lengths of the
+// associated data.
+
+void isap_test_aead(int variant)
+{
+  UChar key[16], npub[16], ad[32], buf[48], tag[16];
+  UChar msg[64], ct1[64], ct2[64], tag2[16];
+  int i, res, mlen, alen, err = 0;
+
+  for (i = 0; i < 16; i++) key[i] = npub[i] = (UChar) i;
+  for (i = 0; i < 32; i++) ad[i] = (UChar) i;
+  memset(buf, 0, sizeof(buf));
+
+  // 1st test: empty message and empty associated data
+
+  printf("Test 1 - C99 implementation:\n");
+  isap_aead_encrypt(buf, tag, buf, 0, ad, 0, npub, key, variant);
+  print_bytes("Tag: ", tag, 16);
+
+  // 2nd test: in-place encryption and decryption
+
+  printf("Test 2 - C99 implementation:\n");
+  for (i = 0; i < 41; i++) buf[i] = (UChar) i;
+  isap_aead_encrypt(buf, tag, buf, 41, ad, 32, npub, key, variant);
+  print_bytes("CT:  ", buf, 41);
+  print_bytes("Tag: ", tag, 16);
+  res = isap_aead_decrypt(buf, buf, 41, tag, ad, 32, npub, key, variant);
+  print_bytes("PT:  ", buf, 41);
+  printf("Verification: %s\n", (res == 0) ? "ok" : "failed");
+
+  // 3rd test: a flipped bit in the ciphertext must be detected before the
+  // decryption, i.e. the buffer still contains the (tampered) ciphertext
+
+  printf("Test 3 - C99 implementation:\n");
+  isap_aead_encrypt(buf, tag, buf, 41, ad, 32, npub, key, variant);
+  buf[40] ^= 0x01;
+  res = isap_aead_decrypt(buf, buf, 41, tag, ad, 32, npub, key, variant);
+  printf("Verification: %s\n", (res == 0) ? "ok" : "failed");
+  print_bytes("CT:  ", buf, 41);
+
+  // 4th test: interleaved encryption
+
+  printf("Test 4 - C99 interleaved implementation:\n");
+  for (i = 0; i < 41; i++) buf[i] = (UChar) i;
+  isap_aead_encrypt_x2(buf, tag, buf, 41, ad, 32, npub, key, variant);
+  print_bytes("CT:  ", buf, 41);
+  print_bytes("Tag: ", tag, 16);
+  for (i = 0; i < 64; i++) msg[i] = (UChar) (3*i + 1);
+  for (mlen = 0; mlen <= 64; mlen++) {
+    for (alen = 0; alen <= 32; alen += 7) {
+      isap_aead_encrypt(ct1, tag, msg, mlen, ad, alen, npub, key, variant);
+      isap_aead_encrypt_x2(ct2, tag2, msg, mlen, ad, alen, npub, key,
+        variant);
+      if (memcmp(ct1, ct2, mlen) != 0 || memcmp(tag, tag2, 16) != 0) err++;
+    }
+  }
+  printf("Mismatches: %i\n", err);
+
+  // Expected result for ISAP-A-128A
+  // -------------------------------
+  // Test 1 - C99 implementation:
+  // Tag: 7b94ef35ae55ab272c9c44d6c1cf0102
+  // Test 2 - C99 implementation:
+  // CT:  2cde28dbbbd9131ebc568d77725b25937cf8edb8a8f50a2aceda356c3ca3d46b6cf4bb9597fdb7abfb
+  // Tag: f32689450d0f5522b3ed9cb6a51bd87a
+  // PT:  000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728
+  // Verification: ok
+  // Test 3 - C99 implementation:
+  // Verification: failed
+  // CT:  2cde28dbbbd9131ebc568d77725b25937cf8edb8a8f50a2aceda356c3ca3d46b6cf4bb9597fdb7abfa
+  // Test 4 - C99 interleaved implementation:
+  // CT:  2cde28dbbbd9131ebc568d77725b25937cf8edb8a8f50a2aceda356c3ca3d46b6cf4bb9597fdb7abfb
+  // Tag: f32689450d0f5522b3ed9cb6a51bd87a
+  // Mismatches: 0
+
+  // Expected result for ISAP-A-128
+  // ------------------------------
+  // Test 1 - C99 implementation:
+  // Tag: 79a08d4d8b9f23d3699cbb91174dd67b
+  // Test 2 - C99 implementation:
+  // CT:  b8529bce1b3f9d0db7a9c8dd43dd35d18e41801a814a29a999102227a4aa747b6ba1af2408ca8da597
+  // Tag: 443bfb439c98e546d1a070e0bf368357
+  // PT:  000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728
+  // Verification: ok
+  // Test 3 - C99 implementation:
+  // Verification: failed
+  // CT:  b8529bce1b3f9d0db7a9c8dd43dd35d18e41801a814a29a999102227a4aa747b6ba1af2408ca8da596
+  // Test 4 - C99 interleaved implementation:
+  // CT:  b8529bce1b3f9d0db7a9c8dd43dd35d18e41801a814a29a999102227a4aa747b6ba1af2408ca8da597
+  // Tag: 443bfb439c98e546d1a070e0bf368357
+  // Mismatches: 0
+}
+
+
+// Benchmark of the rejection of forgeries. For each message length, a valid
+// ciphertext is decrypted `iter` times and a forged one (a flipped bit in
+// the tag) is rejected `iter` times. The printed values are the number of
+// CYCLES() ticks per decryption times 1000 and the ratio of the two in %.
+
+void isap_bench_forgery(int variant, long iter)
+{
+  static const size_t len[4] = { 16, 64, 256, 1024 };
+  static UChar buf[1024], pt[1024];
+  UChar key[16], npub[16], tag[16];
+  unsigned long start, t_dec, t_rej;
+  long n;
+  int i, res = 0;
+
+  for (i = 0; i < 16; i++) key[i] = npub[i] = (UChar) i;
+  for (i = 0; i < 1024; i++) buf[i] = (UChar) i;
+
+  for (i = 0; i < 4; i++) {
+    isap_aead_encrypt(buf, tag, buf, len[i], NULL, 0, npub, key, variant);
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      res += isap_aead_decrypt(pt, buf, len[i], tag, NULL, 0, npub, key,
+        variant);
+    }
+    t_dec = CYCLES() - start;
+    tag[0] ^= 0x01;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      res += isap_aead_decrypt(pt, buf, len[i], tag, NULL, 0, npub, key,
+        variant);
+    }
+    t_rej = CYCLES() - start;
+    printf("%4i bytes: decrypt %llu, reject %llu (%llu%%)\n", (int) len[i],
+      TICKS1000(t_dec, iter), TICKS1000(t_rej, iter), PERCENT(t_rej, t_dec));
+  }
+  printf("Rejected forgeries: %i of %li\n", -res, 4*iter);
+}
+
+
+// Benchmark of the interleaved encryption. Messages of different lengths
+// (without associated data) are encrypted `iter` times with the sequential
+// and the interleaved version; the printed values are the number of CYCLES()
+// ticks per encryption times 1000 and the ratio of the two in %.
+
+void isap_bench_x2(int variant, long iter)
+{
+  static const size_t len[4] = { 16, 64, 256, 1024 };
+  static UChar buf[1024];
+  UChar key[16], npub[16], tag[16];
+  unsigned long start, t_seq, t_x2;
+  long n;
+  int i;
+
+  for (i = 0; i < 16; i++) key[i] = npub[i] = (UChar) i;
+  for (i = 0; i < 1024; i++) buf[i] = (UChar) i;
+
+  for (i = 0; i < 4; i++) {
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      isap_aead_encrypt(buf, tag, buf, len[i], NULL, 0, npub, key, variant);
+    }
+    t_seq = CYCLES() - start;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      isap_aead_encrypt_x2(buf, tag, buf, len[i], NULL, 0, npub, key,
+        variant);
+    }
+    t_x2 = CYCLES() - start;
+    printf("%4i bytes: sequential %llu, interleaved %llu (%llu%%)\n",
+      (int) len[i], TICKS1000(t_seq, iter), TICKS1000(t_x2, iter),
+      PERCENT(t_x2, t_seq));
+  }
+}
@@ -19,6 +19,10 @@
 #include <stdio.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 
 typedef unsigned char UChar;
 typedef unsigned long long int ULLInt;
@@ -42,6 +46,17 @@ typedef union {
 #define DEC 0x0f
 #define END 0x3c
 
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` times 1000 divided by `n`; the result is a
+// ULLInt since 1000*t exceeds 32 bits on MSP430 after 4.29M ticks
+#define TICKS1000(t, n) ((1000*(ULLInt) (t))/(n))
+
 
 #if (defined(__AVR) || defined(__AVR__))
 extern void isap_avr(State *s, int nr);
@@ -51,7 +66,17 @@ extern void isap_avr(State *s, int nr);
 
 #if (defined(__MSP430__) || defined(__ICC430__))
 extern void isap_msp(State *s, int nr);
+extern void isap_msp_p12(State *s);
+extern void isap_msp_p8(State *s);
+extern void isap_msp_p6(State *s);
+extern void isap_msp_p1(State *s);
+extern void isap_msp_rk(State *s, const UChar *y, int nrb);
 #define isap_asm(s, nr) isap_msp((s), (nr))
+#define isap_asm_p12(s) isap_msp_p12((s))
+#define isap_asm_p8(s) isap_msp_p8((s))
+#define isap_asm_p6(s) isap_msp_p6((s))
+#define isap_asm_p1(s) isap_msp_p1((s))
+#define isap_asm_rk(s, y, nrb) isap_msp_rk((s), (y), (nrb))
 #define ISAP_ASSEMBLER
 #endif
 
@@ -180,6 +205,229 @@ void isap_c99_V3(State *s, int nr)
 }
 
 
+// The macro `SBOX` is the substitution layer of isap_c99_V3 on a single
+// slice of 8, 16, 32, or 64 bits. After the s-box, `s2` contains the slice of
+// x[0], `s3` of x[1], `s4` of x[2], `s0` of x[3], and `s1` of x[4].
+
+#define SBOX(s0, s1, s2, s3, s4, ta, tb, tc) do { \
+  ta = s1 ^ s2; tb = s0 ^ s4; tc = s3 ^ s4;       \
+  s4 = (~s4 | s3) ^ ta;                           \
+  s3 = ((s3 ^ s1) | ta) ^ tb;                     \
+  s2 = ((s2 ^ tb) | s1) ^ tc;                     \
+  s1 = (s1 & ~tb) ^ tc;                           \
+  s0 = (s0 | tc) ^ ta;                            \
+} while (0)
+
+// The macro `ROUND` executes a round of the 3rd version of the permutation on
+// the local variables s0-s4 with a round-constant `rc` that is known at
+// compile time. The macros `ROUNDS_Px` are the unrolled sequences of rounds
+// of the permutations p12, p8, p6, and p1; they follow the START/DEC/END
+// schedule, i.e. the 1st round of px uses the round-constant START(x).
+
+#define ROUND(rc) do { \
+  s2 ^= (uint64_t) (rc); \
+  SBOX(s0, s1, s2, s3, s4, ta, tb, tc); \
+  r0 = s2; r1 = s3; r2 = s4; r3 = s0; r4 = s1; \
+  s0 = r0 ^ ROR64(r0, 19) ^ ROR64(r0, 28); \
+  s1 = r1 ^ ROR64(r1, 61) ^ ROR64(r1, 39); \
+  s2 = r2 ^ ROR64(r2,  1) ^ ROR64(r2,  6); \
+  s3 = r3 ^ ROR64(r3, 10) ^ ROR64(r3, 17); \
+  s4 = r4 ^ ROR64(r4,  7) ^ ROR64(r4, 41); \
+} while (0)
+
+#define ROUNDS_P1 ROUND(START(1))
+#define ROUNDS_P6 ROUND(START(6)); ROUND(START(5)); ROUND(START(4)); \
+  ROUND(START(3)); ROUND(START(2)); ROUNDS_P1
+#define ROUNDS_P8 ROUND(START(8)); ROUND(START(7)); ROUNDS_P6
+#define ROUNDS_P12 ROUND(START(12)); ROUND(START(11)); ROUND(START(10)); \
+  ROUND(START(9)); ROUNDS_P8
+
+// The macro `PERMFUNC` generates a fully unrolled permutation function with a
+// fixed number of rounds.
+
+#define PERMFUNC(name, rounds) \
+void name(State *s) \
+{ \
+  uint64_t s0 = s->x[0], s1 = s->x[1], s2 = s->x[2]; \
+  uint64_t s3 = s->x[3], s4 = s->x[4]; \
+  uint64_t ta, tb, tc; \
+  uint64_t r0, r1, r2, r3, r4; \
+  rounds; \
+  s->x[0] = s0; \
+  s->x[1] = s1; \
+  s->x[2] = s2; \
+  s->x[3] = s3; \
+  s->x[4] = s4; \
+}
+
+
+// Specializations of the 3rd version of the ASCON128v12 permutation for 12, 8,
+// 6, and 1 round(s). They are fully unrolled, i.e. there is no loop overhead
+// and all round-constants are immediate operands.
+
+PERMFUNC(isap_c99_p12, ROUNDS_P12)
+PERMFUNC(isap_c99_p8, ROUNDS_P8)
+PERMFUNC(isap_c99_p6, ROUNDS_P6)
+PERMFUNC(isap_c99_p1, ROUNDS_P1)
+
+
+// Permutation with a number of rounds that is only known at run-time. The
+// four common cases are dispatched to the unrolled specializations, all other
+// cases to isap_c99_V3 as fallback.
+
+void isap_c99_pn(State *s, int nr)
+{
+  switch (nr) {
+    case 12: isap_c99_p12(s); break;
+    case 8: isap_c99_p8(s); break;
+    case 6: isap_c99_p6(s); break;
+    case 1: isap_c99_p1(s); break;
+    default: isap_c99_V3(s, nr); break;
+  }
+}
+
+// Main part of the re-keying function ISAP_RK: the 128-bit string `y` is
+// absorbed bit by bit into the most-significant bit of x[0], with `nrb` rounds
+// after each bit but the last and 12 rounds after the last bit. The state has
+// to be initialized with the key and the IV and permuted with 12 rounds
+// before. In contrast to 128 calls of isap_c99_pn, the state is loaded and
+// stored only once and the rounds for sB = 1 and sB = 12 are unrolled.
+
+void isap_c99_rk(State *s, const UChar *y, int nrb)
+{
+  uint64_t s0 = s->x[0], s1 = s->x[1], s2 = s->x[2];
+  uint64_t s3 = s->x[3], s4 = s->x[4];
+  uint64_t ta, tb, tc;
+  uint64_t r0, r1, r2, r3, r4;
+  int i, rc;
+
+  for (i = 0; i < 127; i++) {
+    s0 ^= ((uint64_t) (y[i >> 3] >> (7 - (i & 7)))) << 63;
+    if (nrb == 1) {
+      ROUNDS_P1;
+    } else if (nrb == 12) {
+      ROUNDS_P12;
+    } else {
+      for (rc = START(nrb); rc > END; rc -= DEC) ROUND(rc);
+    }
+  }
+  s0 ^= ((uint64_t) y[15]) << 63;
+  ROUNDS_P12;
+
+  s->x[0] = s0;
+  s->x[1] = s1;
+  s->x[2] = s2;
+  s->x[3] = s3;
+  s->x[4] = s4;
+}
+
+
+// The macro `LINLAYER` is the linear layer of isap_c99_V3 on the output of
+// the macro `SBOX`, i.e. it also moves the words back into `s0`-`s4`.
+
+#define LINLAYER(s0, s1, s2, s3, s4, r0, r1, r2, r3, r4) do { \
+  r0 = s2; r1 = s3; r2 = s4; r3 = s0; r4 = s1; \
+  s0 = r0 ^ ROR64(r0, 19) ^ ROR64(r0, 28); \
+  s1 = r1 ^ ROR64(r1, 61) ^ ROR64(r1, 39); \
+  s2 = r2 ^ ROR64(r2,  1) ^ ROR64(r2,  6); \
+  s3 = r3 ^ ROR64(r3, 10) ^ ROR64(r3, 17); \
+  s4 = r4 ^ ROR64(r4,  7) ^ ROR64(r4, 41); \
+} while (0)
+
+
+// Two-lane version of the permutation for the interleaved execution of the
+// encryption and the MAC of ISAP. It executes `n` rounds on both states,
+// whereby state s[i] is nr[i] rounds away from the end of a permutation, i.e.
+// the round-constants of s[i] start at START(nr[i]). A permutation can thus
+// be split into several calls, which allows to pair e.g. the 12 rounds of
+// the MAC with two times 6 rounds of the encryption. The rounds of the two
+// states are independent and interleaved by the compiler, which hides the
+// latency of the operations of one state behind the other one.
+
+void isap_c99_x2(State *s, const int *nr, int n)
+{
+  uint64_t a0 = s[0].x[0], a1 = s[0].x[1], a2 = s[0].x[2];
+  uint64_t a3 = s[0].x[3], a4 = s[0].x[4];
+  uint64_t b0 = s[1].x[0], b1 = s[1].x[1], b2 = s[1].x[2];
+  uint64_t b3 = s[1].x[3], b4 = s[1].x[4];
+  uint64_t ta, tb, tc, ua, ub, uc;
+  uint64_t r0, r1, r2, r3, r4, q0, q1, q2, q3, q4;
+  int rca = START(nr[0]), rcb = START(nr[1]);
+
+  for (; n > 0; n--) {
+    a2 ^= (uint64_t) rca;
+    b2 ^= (uint64_t) rcb;
+    SBOX(a0, a1, a2, a3, a4, ta, tb, tc);
+    SBOX(b0, b1, b2, b3, b4, ua, ub, uc);
+    LINLAYER(a0, a1, a2, a3, a4, r0, r1, r2, r3, r4);
+    LINLAYER(b0, b1, b2, b3, b4, q0, q1, q2, q3, q4);
+    rca -= DEC;
+    rcb -= DEC;
+  }
+  s[0].x[0] = a0; s[0].x[1] = a1; s[0].x[2] = a2;
+  s[0].x[3] = a3; s[0].x[4] = a4;
+  s[1].x[0] = b0; s[1].x[1] = b1; s[1].x[2] = b2;
+  s[1].x[3] = b3; s[1].x[4] = b4;
+}
+
+
+#if defined(__SSE2__)
+
+// rotation macro for two 64-bit words (AVX-512VL has a rotate instruction,
+// with SSE2 a rotation needs two shifts and an OR)
+#if defined(__AVX512VL__)
+#define ROR128(x, d) _mm_ror_epi64((x), (d))
+#else
+#define ROR128(x, d) _mm_or_si128(_mm_srli_epi64((x), (d)), \
+  _mm_slli_epi64((x), 64 - (d)))
+#endif
+
+// SSE2 version of isap_c99_x2: the two states are the lower and the upper
+// 64-bit lane of five 128-bit vectors and each lane has its own round-constant.
+// It is only faster than the scalar interleaving when the rotations can be
+// done with a single instruction, i.e. when AVX-512VL is available.
+
+void isap_sse2_x2(State *s, const int *nr, int n)
+{
+  __m128i s0, s1, s2, s3, s4, ta, tb, tc, r0, r1, r2, r3, r4;
+  const __m128i ones = _mm_set1_epi64x(-1), dec = _mm_set1_epi64x(DEC);
+  __m128i rcv = _mm_set_epi64x(START(nr[1]), START(nr[0]));
+
+  s0 = _mm_set_epi64x(s[1].x[0], s[0].x[0]);
+  s1 = _mm_set_epi64x(s[1].x[1], s[0].x[1]);
+  s2 = _mm_set_epi64x(s[1].x[2], s[0].x[2]);
+  s3 = _mm_set_epi64x(s[1].x[3], s[0].x[3]);
+  s4 = _mm_set_epi64x(s[1].x[4], s[0].x[4]);
+
+  for (; n > 0; n--) {
+    s2 = _mm_xor_si128(s2, rcv);
+    ta = _mm_xor_si128(s1, s2);
+    tb = _mm_xor_si128(s0, s4);
+    tc = _mm_xor_si128(s3, s4);
+    r2 = _mm_xor_si128(_mm_or_si128(_mm_xor_si128(s4, ones), s3), ta);
+    r1 = _mm_xor_si128(_mm_or_si128(_mm_xor_si128(s3, s1), ta), tb);
+    r0 = _mm_xor_si128(_mm_or_si128(_mm_xor_si128(s2, tb), s1), tc);
+    r4 = _mm_xor_si128(_mm_andnot_si128(tb, s1), tc);
+    r3 = _mm_xor_si128(_mm_or_si128(s0, tc), ta);
+    s0 = _mm_xor_si128(r0, _mm_xor_si128(ROR128(r0, 19), ROR128(r0, 28)));
+    s1 = _mm_xor_si128(r1, _mm_xor_si128(ROR128(r1, 61), ROR128(r1, 39)));
+    s2 = _mm_xor_si128(r2, _mm_xor_si128(ROR128(r2,  1), ROR128(r2,  6)));
+    s3 = _mm_xor_si128(r3, _mm_xor_si128(ROR128(r3, 10), ROR128(r3, 17)));
+    s4 = _mm_xor_si128(r4, _mm_xor_si128(ROR128(r4,  7), ROR128(r4, 41)));
+    rcv = _mm_sub_epi64(rcv, dec);
+  }
+
+  _mm_storeu_si128((__m128i *) &s[0].x[0], _mm_unpacklo_epi64(s0, s1));
+  _mm_storeu_si128((__m128i *) &s[1].x[0], _mm_unpackhi_epi64(s0, s1));
+  _mm_storeu_si128((__m128i *) &s[0].x[2], _mm_unpacklo_epi64(s2, s3));
+  _mm_storeu_si128((__m128i *) &s[1].x[2], _mm_unpackhi_epi64(s2, s3));
+  _mm_storel_epi64((__m128i *) &s[0].x[4], s4);
+  _mm_storel_epi64((__m128i *) &s[1].x[4], _mm_unpackhi_epi64(s4, s4));
+}
+
+#endif
+
+
 // Print the five state-words of ASCON128v12 in Hex format.
 
 static void print_state(State *s)
@@ -291,3 +539,66 @@ void isap_test_perm(int rounds)
   // 0706050403020100 0f0e0d0c0b0a0908 1716151413121110 1f1e1d1c1b1a1918 2726252423222120
   // eabb307b20741574 69f9b6e6f3c87f1c 3ed22b3cefcfe13d ac5b1fd401664b92 e62f2ef2099605d0
 }
+
+
+// Benchmark of the bit-absorption of ISAP_RK with sB = 1 (ISAP-A-128A) and
+// sB = 12 (ISAP-A-128), once with a separate call of the permutation per bit
+// (as in the straightforward implementation of ISAP_RK) and once with the
+// fused function. The printed value is the number of CYCLES() ticks per
+// re-keying times 1000, followed by the checksum of the final state (which
+// has to be identical for all versions).
+
+void isap_bench_rk(long iter)
+{
+  static const int rounds[2] = { 1, 12 };
+  UChar y[16];
+  unsigned long start, stop;
+  State s;
+  long n;
+  int i, r;
+
+  for (i = 0; i < 16; i++) y[i] = (UChar) (17*i + 5);
+
+  for (r = 0; r < 2; r++) {
+    for (i = 0; i < 40; i++) ((uint8_t *) &s)[i] = (uint8_t) i;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      for (i = 0; i < 127; i++) {
+        s.x[0] ^= ((uint64_t) (y[i >> 3] >> (7 - (i & 7)))) << 63;
+#if defined(ISAP_ASSEMBLER)
+        isap_asm(&s, rounds[r]);
+#else
+        isap_c99_pn(&s, rounds[r]);
+#endif
+      }
+      s.x[0] ^= ((uint64_t) y[15]) << 63;
+#if defined(ISAP_ASSEMBLER)
+      isap_asm(&s, 12);
+#else
+      isap_c99_pn(&s, 12);
+#endif
+    }
+    stop = CYCLES();
+    printf("sB = %2i, separate   : %llu (%08lx)\n", rounds[r],
+      TICKS1000(stop - start, iter),
+      (unsigned long) (s.w[0][0] ^ s.w[4][1]));
+
+    for (i = 0; i < 40; i++) ((uint8_t *) &s)[i] = (uint8_t) i;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) isap_c99_rk(&s, y, rounds[r]);
+    stop = CYCLES();
+    printf("sB = %2i, fused (C99): %llu (%08lx)\n", rounds[r],
+      TICKS1000(stop - start, iter),
+      (unsigned long) (s.w[0][0] ^ s.w[4][1]));
+
+#if defined(isap_asm_rk)
+    for (i = 0; i < 40; i++) ((uint8_t *) &s)[i] = (uint8_t) i;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) isap_asm_rk(&s, y, rounds[r]);
+    stop = CYCLES();
+    printf("sB = %2i, fused (ASM): %llu (%08lx)\n", rounds[r],
+      TICKS1000(stop - start, iter),
+      (unsigned long) (s.w[0][0] ^ s.w[4][1]));
+#endif
+  }
+}
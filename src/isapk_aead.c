@@ -0,0 +1,379 @@
+///////////////////////////////////////////////////////////////////////////////
+// isapk_aead.c: C99 implementation and unit-test of ISAP-K-128(A) AEAD.     //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+// The state of Keccak-p[400] consists of 25 lanes of 16 bits. ISAP-K is
+// specified on the byte-representation of the state, in which the lanes are
+// little-endian, i.e. byte i of the state is b[i] on a little-endian host
+// like MSP430, AVR and x86.
+typedef union {
+  uint16_t w[25];
+  uint8_t b[50];
+} KState;
+
+
+// variants
+#define ISAPK128A 0  // sH = 16, sB = 1, sE = 8, sK = 8
+#define ISAPK128  1  // sH = 20, sB = 12, sE = 12, sK = 12
+
+// rate of the hash (rH = 144 bits) and size of the state in bytes
+#define RATE  18
+#define STSZ  50
+
+// flags of the initialization vectors of the MAC (IV_A), the re-keying for
+// the MAC (IV_KA), and the re-keying for the encryption (IV_KE)
+#define FLAG_A  0x01
+#define FLAG_KA 0x02
+#define FLAG_KE 0x03
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` times 1000 divided by `n`; the result is a
+// ULLInt since 1000*t exceeds 32 bits on MSP430 after 4.29M ticks
+#define TICKS1000(t, n) ((1000*(ULLInt) (t))/(n))
+
+
+extern void keccak400_c99_V2(uint16_t *a, int nr);
+
+#if (defined(__MSP430__) || defined(__ICC430__))
+extern void keccak400_msp(uint16_t *state, int rounds);
+#define keccak400_asm(state, rounds) keccak400_msp((state), (rounds))
+#define KECCAK400_ASSEMBLER
+#endif
+
+// the mode uses the Assembler permutation when available, otherwise the
+// optimized C99 permutation from keccak400_perm.c
+#if defined(KECCAK400_ASSEMBLER)
+#define KECCAK400_PERM(s, nr) keccak400_asm((s)->w, (nr))
+#else
+#define KECCAK400_PERM(s, nr) keccak400_c99_V2((s)->w, (nr))
+#endif
+
+
+// Round numbers of the two variants and the initialization vector without
+// the 8-bit flag in the first byte, i.e. k || rH || rB || sH || sB || sE ||
+// sK.
+
+typedef struct {
+  int sh, sb, se, sk;
+  UChar iv[7];
+} IsapKParams;
+
+static const IsapKParams PARAMS[2] = {
+  { 16,  1,  8,  8, { 128, 144, 1, 16,  1,  8,  8 } },  // ISAP-K-128A
+  { 20, 12, 12, 12, { 128, 144, 1, 20, 12, 12, 12 } }   // ISAP-K-128
+};
+
+
+// Initialization of the state with a 16-byte value `x` (the key or the
+// nonce) and the initialization vector with flag `flag`, followed by a
+// permutation with `nr` rounds.
+
+static void isapk_init(KState *s, const UChar *x, UChar flag,
+  const IsapKParams *p, int nr)
+{
+  memset(s, 0, sizeof(KState));
+  memcpy(s->b, x, 16);
+  s->b[16] = flag;
+  memcpy(s->b + 17, p->iv, 7);
+  KECCAK400_PERM(s, nr);
+}
+
+
+// Re-keying function ISAP_RK: the key and the initialization vector are
+// permuted with sK rounds, then the 128-bit value `y` is absorbed bit by bit
+// into the most-significant bit of the first state byte (with sB rounds
+// after every bit but the last and sK rounds after the last bit). The
+// session key is in the first bytes of the state, namely 16 bytes for the
+// MAC and 34 bytes for the encryption.
+
+static void isapk_rk(KState *s, const UChar *key, UChar flag, const UChar *y,
+  const IsapKParams *p)
+{
+  int i;
+
+  isapk_init(s, key, flag, p, p->sk);
+  for (i = 0; i < 127; i++) {
+    s->b[0] ^= (UChar) ((y[i >> 3] << (i & 7)) & 0x80);
+    KECCAK400_PERM(s, p->sb);
+  }
+  s->b[0] ^= (UChar) ((y[15] << 7) & 0x80);
+  KECCAK400_PERM(s, p->sk);
+}
+
+
+// Absorption of the associated data or the ciphertext into the MAC state
+// with a rate of 18 bytes and sH rounds. The data is always padded, i.e. an
+// empty input or an input whose length is a multiple of 18 yields an extra
+// block.
+
+static void isapk_absorb(KState *s, const UChar *in, size_t inlen,
+  const IsapKParams *p)
+{
+  size_t i;
+
+  while (inlen >= RATE) {
+    for (i = 0; i < RATE; i++) s->b[i] ^= in[i];
+    KECCAK400_PERM(s, p->sh);
+    in += RATE;
+    inlen -= RATE;
+  }
+  for (i = 0; i < inlen; i++) s->b[i] ^= in[i];
+  s->b[inlen] ^= 0x80;
+  KECCAK400_PERM(s, p->sh);
+}
+
+
+// Computation of the 128-bit tag over the associated data and the ciphertext
+// (ISAP_MAC). The nonce and IV_A are permuted, the associated data and the
+// ciphertext are absorbed (with a domain separation in the last state byte
+// in between), and the first 16 bytes of the state are replaced by the
+// session key derived with ISAP_RK from them before the final permutation.
+
+static void isapk_mac(UChar *tag, const UChar *c, size_t clen,
+  const UChar *ad, size_t adlen, const UChar *npub, const UChar *key,
+  int variant)
+{
+  const IsapKParams *p = &PARAMS[variant];
+  KState s, t;
+
+  isapk_init(&s, npub, FLAG_A, p, p->sh);
+  isapk_absorb(&s, ad, adlen, p);
+  s.b[STSZ-1] ^= 0x01;
+  isapk_absorb(&s, c, clen, p);
+  isapk_rk(&t, key, FLAG_KA, s.b, p);
+  memcpy(s.b, t.b, 16);
+  KECCAK400_PERM(&s, p->sh);
+  memcpy(tag, s.b, 16);
+}
+
+
+// Encryption or decryption (ISAP_ENC): the 272-bit session key derived with
+// ISAP_RK from the nonce and the nonce form the state, which is permuted
+// with sE rounds before each 18-byte block of the key stream is extracted.
+// The output `out` can be the same buffer as the input `in`.
+
+static void isapk_enc(UChar *out, const UChar *in, size_t len,
+  const UChar *npub, const UChar *key, int variant)
+{
+  const IsapKParams *p = &PARAMS[variant];
+  KState s;
+  size_t i, blen;
+
+  if (len == 0) return;
+  isapk_rk(&s, key, FLAG_KE, npub, p);
+  memcpy(s.b + STSZ - 16, npub, 16);
+  while (len > 0) {
+    KECCAK400_PERM(&s, p->se);
+    blen = MIN(len, RATE);
+    for (i = 0; i < blen; i++) out[i] = in[i] ^ s.b[i];
+    in += blen;
+    out += blen;
+    len -= blen;
+  }
+}
+
+
+// One-shot encryption; the `variant` is either ISAPK128A or ISAPK128. The
+// ciphertext `c` can be the same buffer as the plaintext `m`.
+
+void isapk_aead_encrypt(UChar *c, UChar *tag, const UChar *m, size_t mlen,
+  const UChar *ad, size_t adlen, const UChar *npub, const UChar *key,
+  int variant)
+{
+  isapk_enc(c, m, mlen, npub, key, variant);
+  isapk_mac(tag, c, mlen, ad, adlen, npub, key, variant);
+}
+
+
+// One-shot decryption. Like for ISAP-A, the tag is verified (in constant
+// time) before the key stream is generated, i.e. a forgery is rejected with
+// -1 and `m` is not modified at all.
+
+int isapk_aead_decrypt(UChar *m, const UChar *c, size_t clen,
+  const UChar *tag, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant)
+{
+  UChar t[16], diff = 0;
+  int i;
+
+  isapk_mac(t, c, clen, ad, adlen, npub, key, variant);
+  for (i = 0; i < 16; i++) diff |= t[i] ^ tag[i];
+  if (diff != 0) return -1;
+  isapk_enc(m, c, clen, npub, key, variant);
+
+  return 0;
+}
+
+
+// Print a byte-array in Hex format (the output is limited to the first 64
+// bytes of the byte-array).
+
+static void print_bytes(const char* str, const UChar *bytearray, size_t len)
+{
+  UChar buffer[148], byte;
+  size_t i, j, slen = 0;
+
+  if (str != NULL) {
+    slen = MIN(16, strlen(str));
+    memcpy(buffer, str, slen);
+  }
+
+  j = slen;
+  for (i = 0; i < MIN(64, len); i++) {
+    byte = bytearray[i] >> 4;
+    // replace 87 by 55 to get uppercase letters
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+    byte = bytearray[i] & 0xf;
+    buffer[j++] = byte + ((byte < 10) ? 48 : 87);
+  }
+  if (len > 64) {
+    buffer[j] = buffer[j+1] = buffer[j+2] = '.';
+    j += 3;
+  }
+  buffer[j] = '\0';
+
+  printf("%s\n", buffer);
+}
+
+
+// Simple test function for ISAP-K-128A and ISAP-K-128. The 1st test uses the
+// key and nonce of the NIST KAT files with empty message and associated
+// data, the 2nd test encrypts a 41-byte message (i.e. two full blocks and a
+// partial one) with 32 bytes of associated data (in place) and decrypts it
+// again, and the 3rd test checks that a tampered ciphertext is rejected
+// without touching the output buffer.
+
+void isapk_test_aead(int variant)
+{
+  UChar key[16], npub[16], ad[32], buf[48], tag[16];
+  int i, res;
+
+  for (i = 0; i < 16; i++) key[i] = npub[i] = (UChar) i;
+  for (i = 0; i < 32; i++) ad[i] = (UChar) i;
+  memset(buf, 0, sizeof(buf));
+
+  // 1st test: empty message and empty associated data
+
+  printf("Test 1 - C99 implementation:\n");
+  isapk_aead_encrypt(buf, tag, buf, 0, ad, 0, npub, key, variant);
+  print_bytes("Tag: ", tag, 16);
+
+  // 2nd test: in-place encryption and decryption
+
+  printf("Test 2 - C99 implementation:\n");
+  for (i = 0; i < 41; i++) buf[i] = (UChar) i;
+  isapk_aead_encrypt(buf, tag, buf, 41, ad, 32, npub, key, variant);
+  print_bytes("CT:  ", buf, 41);
+  print_bytes("Tag: ", tag, 16);
+  res = isapk_aead_decrypt(buf, buf, 41, tag, ad, 32, npub, key, variant);
+  print_bytes("PT:  ", buf, 41);
+  printf("Verification: %s\n", (res == 0) ? "ok" : "failed");
+
+  // 3rd test: a flipped bit in the ciphertext must be detected before the
+  // decryption, i.e. the buffer still contains the (tampered) ciphertext
+
+  printf("Test 3 - C99 implementation:\n");
+  isapk_aead_encrypt(buf, tag, buf, 41, ad, 32, npub, key, variant);
+  buf[40] ^= 0x01;
+  res = isapk_aead_decrypt(buf, buf, 41, tag, ad, 32, npub, key, variant);
+  printf("Verification: %s\n", (res == 0) ? "ok" : "failed");
+  print_bytes("CT:  ", buf, 41);
+
+  // Expected result for ISAP-K-128A
+  // -------------------------------
+  // Test 1 - C99 implementation:
+  // Tag: 1aa1f2f89901a41b0664c695d4d7abb9
+  // Test 2 - C99 implementation:
+  // CT:  01bc9ccb186e4a3732e86b9fac4abf3e6c4a8274a185ff3443158cc56f13b59a49a6c85d1e4942151c
+  // Tag: 0f739b23ec791aff8017b02fc72fc4bd
+  // PT:  000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728
+  // Verification: ok
+  // Test 3 - C99 implementation:
+  // Verification: failed
+  // CT:  01bc9ccb186e4a3732e86b9fac4abf3e6c4a8274a185ff3443158cc56f13b59a49a6c85d1e4942151d
+
+  // Expected result for ISAP-K-128
+  // ------------------------------
+  // Test 1 - C99 implementation:
+  // Tag: 104e625d372e27eee4d4e3ce1ca39d1b
+  // Test 2 - C99 implementation:
+  // CT:  59d5a45bcbcb332311869b73f633d29606056b791f8a684e4d876cc1b7ad73a3829e91974e7a043b3d
+  // Tag: 71e50dbd133941863db57ee9673050a0
+  // PT:  000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728
+  // Verification: ok
+  // Test 3 - C99 implementation:
+  // Verification: failed
+  // CT:  59d5a45bcbcb332311869b73f633d29606056b791f8a684e4d876cc1b7ad73a3829e91974e7a043b3c
+}
+
+
+// Benchmark of ISAP-K next to ISAP-A. Messages of different lengths (without
+// associated data) are encrypted `iter` times with ISAP-K-128A and with
+// ISAP-A-128A; the printed values are the number of CYCLES() ticks per
+// encryption times 1000.
+
+extern void isap_aead_encrypt(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant);
+#define ISAPA128A 0
+
+void isapk_bench_aead(long iter)
+{
+  static const size_t len[4] = { 16, 64, 256, 1024 };
+  static UChar buf[1024];
+  UChar key[16], npub[16], tag[16];
+  unsigned long start, t_k, t_a;
+  long n;
+  int i;
+
+  for (i = 0; i < 16; i++) key[i] = npub[i] = (UChar) i;
+  for (i = 0; i < 1024; i++) buf[i] = (UChar) i;
+
+  for (i = 0; i < 4; i++) {
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      isapk_aead_encrypt(buf, tag, buf, len[i], NULL, 0, npub, key,
+        ISAPK128A);
+    }
+    t_k = CYCLES() - start;
+    start = CYCLES();
+    for (n = 0; n < iter; n++) {
+      isap_aead_encrypt(buf, tag, buf, len[i], NULL, 0, npub, key,
+        ISAPA128A);
+    }
+    t_a = CYCLES() - start;
+    printf("%4i bytes: ISAP-K-128A %llu, ISAP-A-128A %llu\n", (int) len[i],
+      TICKS1000(t_k, iter), TICKS1000(t_a, iter));
+  }
+}
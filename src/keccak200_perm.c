@@ -0,0 +1,357 @@
+///////////////////////////////////////////////////////////////////////////////
+// keccak200_perm.c: C99 implementation and unit-test of Keccak-f[200] perm. //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+typedef uint8_t tKeccakLane;
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+
+#define NROUNDS 18
+#define NLANES 25
+
+// rotation and index macro
+#define ROL8(a, b) ((tKeccakLane) ((((uint8_t) (a)) << ((b) % 8)) | \
+  (((uint8_t) (a)) >> ((8 - ((b) % 8)) % 8))))
+#define IDX(x, y) ((((y) % 5) * 5) + ((x) % 5))
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` times 1000 divided by `n`; the result is a
+// ULLInt since 1000*t exceeds 32 bits on MSP430 after 4.29M ticks
+#define TICKS1000(t, n) ((1000*(ULLInt) (t))/(n))
+
+
+#if (defined(__MSP430__) || defined(__ICC430__))
+extern void keccak200_msp(uint8_t *state);
+#define keccak200_asm(state) keccak200_msp((state))
+#define KECCAK200_ASSEMBLER
+#endif
+
+
+// The round constants are the 8 least-significant bits of the 64-bit round
+// constants of Keccak-f[1600]. Keccak-f[200] (the permutation of Elephant
+// instance Delirium) always executes all 18 rounds.
+
+static const tKeccakLane RC[NROUNDS] = {
+  0x01, 0x82, 0x8A, 0x00, 0x8B, 0x01, 0x81, 0x09, 0x8A,
+  0x88, 0x09, 0x0A, 0x8B, 0x8B, 0x89, 0x03, 0x02, 0x80
+};
+
+// rotation offsets of rho for lane A(x,y) at index x+5*y (they are reduced
+// modulo 8 by the macro ROL8)
+static const uint8_t RHO[NLANES] = {
+   0,  1, 62, 28, 27, 36, 44,  6, 55, 20,  3, 10, 43,
+  25, 39, 41, 45, 15, 21,  8, 18,  2, 61, 56, 14
+};
+
+
+// The 1st version of the Keccak-f[200] permutation is based on the source
+// code in `KeccakP-200-reference.c` (functions `theta`, `rho`, `pi`, `chi`
+// and `iota`) of the `ref` implementation from the designers (see XKCP on
+// GitHub in the directory `lib/low/KeccakP-200/ref`).
+
+void keccak200_c99(tKeccakLane *a)
+{
+  tKeccakLane b[NLANES], c[5], d[5];
+  unsigned int x, y;
+  int i;
+
+  for (i = 0; i < NROUNDS; ++i) {
+
+    // Theta: column parity mixer
+    for (x = 0; x < 5; ++x) {
+      c[x] = a[IDX(x, 0)] ^ a[IDX(x, 1)] ^ a[IDX(x, 2)] ^ a[IDX(x, 3)] ^
+        a[IDX(x, 4)];
+    }
+    for (x = 0; x < 5; ++x) {
+      d[x] = c[(x+4)%5] ^ ROL8(c[(x+1)%5], 1);
+    }
+    for (x = 0; x < 5; ++x) {
+      for (y = 0; y < 5; ++y) {
+        a[IDX(x, y)] ^= d[x];
+      }
+    }
+
+    // Rho: rotation of each lane
+    for (x = 0; x < 5; ++x) {
+      for (y = 0; y < 5; ++y) {
+        a[IDX(x, y)] = ROL8(a[IDX(x, y)], RHO[IDX(x, y)]);
+      }
+    }
+
+    // Pi: permutation of the lanes
+    memcpy(b, a, sizeof(b));
+    for (x = 0; x < 5; ++x) {
+      for (y = 0; y < 5; ++y) {
+        a[IDX(y, 2*x+3*y)] = b[IDX(x, y)];
+      }
+    }
+
+    // Chi: non-linear layer (horizontally)
+    for (y = 0; y < 5; ++y) {
+      for (x = 0; x < 5; ++x) {
+        c[x] = a[IDX(x, y)] ^ (~a[IDX(x+1, y)] & a[IDX(x+2, y)]);
+      }
+      for (x = 0; x < 5; ++x) {
+        a[IDX(x, y)] = c[x];
+      }
+    }
+
+    // Iota: addition of round constant
+    a[0] ^= RC[i];
+  }
+}
+
+
+// The 2nd version of the Keccak-f[200] permutation is unrolled in the same
+// way as keccak400_c99_V2, i.e. Theta (the addition of the column parities),
+// Rho and Pi are merged into a single step that computes each lane of the
+// intermediate state `b` directly from the corresponding lane of `a`, and
+// Chi writes the result back to `a`. (Packing the five 8-bit lanes of a row
+// into a 64-bit word for Chi turned out to be slower on x86-64 due to the
+// packing and unpacking.)
+
+void keccak200_c99_V2(tKeccakLane *a)
+{
+  tKeccakLane b[NLANES], c[5], d[5];
+  int i, y;
+
+  for (i = 0; i < NROUNDS; ++i) {
+
+    // Theta: column parity mixer
+    c[0] = a[0] ^ a[5] ^ a[10] ^ a[15] ^ a[20];
+    c[1] = a[1] ^ a[6] ^ a[11] ^ a[16] ^ a[21];
+    c[2] = a[2] ^ a[7] ^ a[12] ^ a[17] ^ a[22];
+    c[3] = a[3] ^ a[8] ^ a[13] ^ a[18] ^ a[23];
+    c[4] = a[4] ^ a[9] ^ a[14] ^ a[19] ^ a[24];
+    d[0] = c[4] ^ ROL8(c[1], 1);
+    d[1] = c[0] ^ ROL8(c[2], 1);
+    d[2] = c[1] ^ ROL8(c[3], 1);
+    d[3] = c[2] ^ ROL8(c[4], 1);
+    d[4] = c[3] ^ ROL8(c[0], 1);
+
+    // Theta, Rho, and Pi
+    b[ 0] = a[ 0] ^ d[0];
+    b[ 1] = ROL8(a[ 6] ^ d[1], 4);
+    b[ 2] = ROL8(a[12] ^ d[2], 3);
+    b[ 3] = ROL8(a[18] ^ d[3], 5);
+    b[ 4] = ROL8(a[24] ^ d[4], 6);
+    b[ 5] = ROL8(a[ 3] ^ d[3], 4);
+    b[ 6] = ROL8(a[ 9] ^ d[4], 4);
+    b[ 7] = ROL8(a[10] ^ d[0], 3);
+    b[ 8] = ROL8(a[16] ^ d[1], 5);
+    b[ 9] = ROL8(a[22] ^ d[2], 5);
+    b[10] = ROL8(a[ 1] ^ d[1], 1);
+    b[11] = ROL8(a[ 7] ^ d[2], 6);
+    b[12] = ROL8(a[13] ^ d[3], 1);
+    b[13] = a[19] ^ d[4];
+    b[14] = ROL8(a[20] ^ d[0], 2);
+    b[15] = ROL8(a[ 4] ^ d[4], 3);
+    b[16] = ROL8(a[ 5] ^ d[0], 4);
+    b[17] = ROL8(a[11] ^ d[1], 2);
+    b[18] = ROL8(a[17] ^ d[2], 7);
+    b[19] = a[23] ^ d[3];
+    b[20] = ROL8(a[ 2] ^ d[2], 6);
+    b[21] = ROL8(a[ 8] ^ d[3], 7);
+    b[22] = ROL8(a[14] ^ d[4], 7);
+    b[23] = ROL8(a[15] ^ d[0], 1);
+    b[24] = ROL8(a[21] ^ d[1], 2);
+
+    // Chi: non-linear layer (horizontally)
+    for (y = 0; y < NLANES; y += 5) {
+      a[y+0] = b[y+0] ^ (~b[y+1] & b[y+2]);
+      a[y+1] = b[y+1] ^ (~b[y+2] & b[y+3]);
+      a[y+2] = b[y+2] ^ (~b[y+3] & b[y+4]);
+      a[y+3] = b[y+3] ^ (~b[y+4] & b[y+0]);
+      a[y+4] = b[y+4] ^ (~b[y+0] & b[y+1]);
+    }
+
+    // Iota: addition of round constant
+    a[0] ^= RC[i];
+  }
+}
+
+
+// Print the 25 state-bytes of Keccak-f[200] in Hex format
+
+static void print_state(const tKeccakLane *a)
+{
+  UChar buffer[9*NLANES], byte;
+  int i, j, k, l = 0;
+
+  for (i = 0; i < 5; i++) {
+    for (j = 0; j < 5; j++) {
+      buffer[l++] = 'a';
+      buffer[l++] = i + 48;
+      buffer[l++] = j + 48;
+      buffer[l++] = ':';
+      buffer[l++] = ' ';
+      for (k = 1; k >= 0; k--) {
+        byte = (a[5*i+j] >> 4*k) & 0xf;
+        // replace 87 by 55 to get uppercase letters
+        buffer[l++] = byte + ((byte < 10) ? 48 : 87);
+      }
+      if (j < 4) {
+        buffer[l++] = ',';
+        buffer[l++] = ' ';
+      }
+    }
+    buffer[l++] = '\n';
+  }
+  buffer[l-1] = '\0';
+
+  printf("%s\n", buffer);
+}
+
+
+// Simple test function for the Keccak-f[200] permutation.
+
+void keccak200_test_perm(void)
+{
+  tKeccakLane state[NLANES];
+  int i;
+
+  // 1st test: state is initialized with all-0 bytes
+
+  printf("Test 1 - C99 implementation:\n");
+  for (i = 0; i < NLANES; i++) state[i] = 0;
+  print_state(state);
+  keccak200_c99(state);  // permutation in C
+  print_state(state);
+
+#if defined(KECCAK200_ASSEMBLER)
+  printf("Test 1 - ASM implementation:\n");
+  for (i = 0; i < NLANES; i++) state[i] = 0;
+  print_state(state);
+  keccak200_asm(state);  // permutation in ASM
+  print_state(state);
+#endif
+
+  // 2nd test: state is initialized with byte-indeces
+
+  printf("Test 2 - C99 implementation (V2):\n");
+  for (i = 0; i < NLANES; i++) state[i] = (tKeccakLane) i;
+  print_state(state);
+  keccak200_c99_V2(state);  // permutation in C
+  print_state(state);
+
+#if defined(KECCAK200_ASSEMBLER)
+  printf("Test 2 - ASM implementation:\n");
+  for (i = 0; i < NLANES; i++) state[i] = (tKeccakLane) i;
+  print_state(state);
+  keccak200_asm(state);  // permutation in ASM
+  print_state(state);
+#endif
+
+  // Expected result
+  // ---------------
+  // Test 1 - C99 implementation:
+  // a00: 00, a01: 00, a02: 00, a03: 00, a04: 00
+  // a10: 00, a11: 00, a12: 00, a13: 00, a14: 00
+  // a20: 00, a21: 00, a22: 00, a23: 00, a24: 00
+  // a30: 00, a31: 00, a32: 00, a33: 00, a34: 00
+  // a40: 00, a41: 00, a42: 00, a43: 00, a44: 00
+  // a00: 3c, a01: 28, a02: 26, a03: 84, a04: 1c
+  // a10: b3, a11: 5c, a12: 17, a13: 1e, a14: aa
+  // a20: e9, a21: b8, a22: 11, a23: 13, a24: 4c
+  // a30: ea, a31: a3, a32: 85, a33: 2c, a34: 69
+  // a40: d2, a41: c5, a42: ab, a43: af, a44: ea
+  // Test 1 - ASM implementation:
+  // a00: 00, a01: 00, a02: 00, a03: 00, a04: 00
+  // a10: 00, a11: 00, a12: 00, a13: 00, a14: 00
+  // a20: 00, a21: 00, a22: 00, a23: 00, a24: 00
+  // a30: 00, a31: 00, a32: 00, a33: 00, a34: 00
+  // a40: 00, a41: 00, a42: 00, a43: 00, a44: 00
+  // a00: 3c, a01: 28, a02: 26, a03: 84, a04: 1c
+  // a10: b3, a11: 5c, a12: 17, a13: 1e, a14: aa
+  // a20: e9, a21: b8, a22: 11, a23: 13, a24: 4c
+  // a30: ea, a31: a3, a32: 85, a33: 2c, a34: 69
+  // a40: d2, a41: c5, a42: ab, a43: af, a44: ea
+  // Test 2 - C99 implementation (V2):
+  // a00: 00, a01: 01, a02: 02, a03: 03, a04: 04
+  // a10: 05, a11: 06, a12: 07, a13: 08, a14: 09
+  // a20: 0a, a21: 0b, a22: 0c, a23: 0d, a24: 0e
+  // a30: 0f, a31: 10, a32: 11, a33: 12, a34: 13
+  // a40: 14, a41: 15, a42: 16, a43: 17, a44: 18
+  // a00: 7f, a01: 03, a02: 40, a03: bd, a04: 5e
+  // a10: f9, a11: a9, a12: ce, a13: 6c, a14: 77
+  // a20: d1, a21: 41, a22: ea, a23: 91, a24: 23
+  // a30: 77, a31: 2d, a32: 83, a33: f0, a34: 40
+  // a40: bf, a41: 23, a42: 1c, a43: a5, a44: 1c
+  // Test 2 - ASM implementation:
+  // a00: 00, a01: 01, a02: 02, a03: 03, a04: 04
+  // a10: 05, a11: 06, a12: 07, a13: 08, a14: 09
+  // a20: 0a, a21: 0b, a22: 0c, a23: 0d, a24: 0e
+  // a30: 0f, a31: 10, a32: 11, a33: 12, a34: 13
+  // a40: 14, a41: 15, a42: 16, a43: 17, a44: 18
+  // a00: 7f, a01: 03, a02: 40, a03: bd, a04: 5e
+  // a10: f9, a11: a9, a12: ce, a13: 6c, a14: 77
+  // a20: d1, a21: 41, a22: ea, a23: 91, a24: 23
+  // a30: 77, a31: 2d, a32: 83, a33: f0, a34: 40
+  // a40: bf, a41: 23, a42: 1c, a43: a5, a44: 1c
+}
+
+
+// Benchmark of the permutation versions on the same input. Each version is
+// executed `iter` times on the state of the 2nd test. The printed value is the
+// number of CYCLES() ticks per permutation call times 1000, followed by the
+// checksum of the final state (which is identical for all versions).
+
+void keccak200_bench_perm(long iter)
+{
+  tKeccakLane state[NLANES];
+  unsigned long start, stop;
+  long n;
+  int i;
+
+  for (i = 0; i < NLANES; i++) state[i] = (tKeccakLane) i;
+  start = CYCLES();
+  for (n = 0; n < iter; n++) keccak200_c99(state);
+  stop = CYCLES();
+  printf("keccak200_c99   : %llu (%02x)\n", TICKS1000(stop - start, iter),
+    (unsigned int) (state[0] ^ state[24]));
+
+  for (i = 0; i < NLANES; i++) state[i] = (tKeccakLane) i;
+  start = CYCLES();
+  for (n = 0; n < iter; n++) keccak200_c99_V2(state);
+  stop = CYCLES();
+  printf("keccak200_c99_V2: %llu (%02x)\n", TICKS1000(stop - start, iter),
+    (unsigned int) (state[0] ^ state[24]));
+
+#if defined(KECCAK200_ASSEMBLER)
+  for (i = 0; i < NLANES; i++) state[i] = (tKeccakLane) i;
+  start = CYCLES();
+  for (n = 0; n < iter; n++) keccak200_asm(state);
+  stop = CYCLES();
+  printf("keccak200_asm   : %llu (%02x)\n", TICKS1000(stop - start, iter),
+    (unsigned int) (state[0] ^ state[24]));
+#endif
+}
@@ -0,0 +1,358 @@
+///////////////////////////////////////////////////////////////////////////////
+// keccak400_perm.c: C99 implementation and unit-test of Keccak-p[400] perm. //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+typedef uint16_t tKeccakLane;
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+
+#define MAXROUNDS 20
+#define NLANES 25
+
+// rotation and index macro
+#define ROL16(a, b) ((tKeccakLane) ((((uint16_t) (a)) << ((b) % 16)) | \
+  (((uint16_t) (a)) >> ((16 - ((b) % 16)) % 16))))
+#define IDX(x, y) ((((y) % 5) * 5) + ((x) % 5))
+
+// min/max macros
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+// number of CYCLES() ticks `t` times 1000 divided by `n`; the result is a
+// ULLInt since 1000*t exceeds 32 bits on MSP430 after 4.29M ticks
+#define TICKS1000(t, n) ((1000*(ULLInt) (t))/(n))
+
+
+#if (defined(__MSP430__) || defined(__ICC430__))
+extern void keccak400_msp(uint16_t *state, int rounds);
+#define keccak400_asm(state, rounds) keccak400_msp((state), (rounds))
+#define KECCAK400_ASSEMBLER
+#endif
+
+
+// The round constants are the 16 least-significant bits of the 64-bit round
+// constants of Keccak-f[1600]. A permutation with `nr` rounds executes the
+// last `nr` of the 20 rounds of Keccak-f[400], i.e. it uses RC[20-nr]-RC[19].
+
+static const tKeccakLane RC[MAXROUNDS] = {
+  0x0001, 0x8082, 0x808A, 0x8000, 0x808B, 0x0001, 0x8081, 0x8009,
+  0x008A, 0x0088, 0x8009, 0x000A, 0x808B, 0x008B, 0x8089, 0x8003,
+  0x8002, 0x0080, 0x800A, 0x000A
+};
+
+// rotation offsets of rho for lane A(x,y) at index x+5*y (they are reduced
+// modulo 16 by the macro ROL16)
+static const uint8_t RHO[NLANES] = {
+   0,  1, 62, 28, 27, 36, 44,  6, 55, 20,  3, 10, 43,
+  25, 39, 41, 45, 15, 21,  8, 18,  2, 61, 56, 14
+};
+
+
+// The 1st version of the Keccak-p[400] permutation is based on the source
+// code in `KeccakP-400-reference.c` (functions `theta`, `rho`, `pi`, `chi`
+// and `iota`) of the `ref` implementation from the designers (see XKCP on
+// GitHub in the directory `lib/low/KeccakP-400/ref`).
+
+void keccak400_c99(tKeccakLane *a, int nr)
+{
+  tKeccakLane b[NLANES], c[5], d[5];
+  unsigned int x, y;
+  int i;
+
+  for (i = MAXROUNDS - nr; i < MAXROUNDS; ++i) {
+
+    // Theta: column parity mixer
+    for (x = 0; x < 5; ++x) {
+      c[x] = a[IDX(x, 0)] ^ a[IDX(x, 1)] ^ a[IDX(x, 2)] ^ a[IDX(x, 3)] ^
+        a[IDX(x, 4)];
+    }
+    for (x = 0; x < 5; ++x) {
+      d[x] = c[(x+4)%5] ^ ROL16(c[(x+1)%5], 1);
+    }
+    for (x = 0; x < 5; ++x) {
+      for (y = 0; y < 5; ++y) {
+        a[IDX(x, y)] ^= d[x];
+      }
+    }
+
+    // Rho: rotation of each lane
+    for (x = 0; x < 5; ++x) {
+      for (y = 0; y < 5; ++y) {
+        a[IDX(x, y)] = ROL16(a[IDX(x, y)], RHO[IDX(x, y)]);
+      }
+    }
+
+    // Pi: permutation of the lanes
+    memcpy(b, a, sizeof(b));
+    for (x = 0; x < 5; ++x) {
+      for (y = 0; y < 5; ++y) {
+        a[IDX(y, 2*x+3*y)] = b[IDX(x, y)];
+      }
+    }
+
+    // Chi: non-linear layer (horizontally)
+    for (y = 0; y < 5; ++y) {
+      for (x = 0; x < 5; ++x) {
+        c[x] = a[IDX(x, y)] ^ (~a[IDX(x+1, y)] & a[IDX(x+2, y)]);
+      }
+      for (x = 0; x < 5; ++x) {
+        a[IDX(x, y)] = c[x];
+      }
+    }
+
+    // Iota: addition of round constant
+    a[0] ^= RC[i];
+  }
+}
+
+
+// The 2nd version of the Keccak-p[400] permutation is fully unrolled inside
+// the round function and merges Theta (the addition of the column parities),
+// Rho and Pi into a single step: each lane of the intermediate state `b` is
+// computed directly from the corresponding lane of `a`, i.e. b[IDX(y, 2x+3y)]
+// = ROL16(a[IDX(x, y)] ^ d[x], RHO[IDX(x, y)]). Chi then writes the result
+// back to `a`, so that each lane is loaded and stored exactly once in these
+// three steps.
+
+void keccak400_c99_V2(tKeccakLane *a, int nr)
+{
+  tKeccakLane b[NLANES], c[5], d[5];
+  int i, y;
+
+  for (i = MAXROUNDS - nr; i < MAXROUNDS; ++i) {
+
+    // Theta: column parity mixer
+    c[0] = a[0] ^ a[5] ^ a[10] ^ a[15] ^ a[20];
+    c[1] = a[1] ^ a[6] ^ a[11] ^ a[16] ^ a[21];
+    c[2] = a[2] ^ a[7] ^ a[12] ^ a[17] ^ a[22];
+    c[3] = a[3] ^ a[8] ^ a[13] ^ a[18] ^ a[23];
+    c[4] = a[4] ^ a[9] ^ a[14] ^ a[19] ^ a[24];
+    d[0] = c[4] ^ ROL16(c[1], 1);
+    d[1] = c[0] ^ ROL16(c[2], 1);
+    d[2] = c[1] ^ ROL16(c[3], 1);
+    d[3] = c[2] ^ ROL16(c[4], 1);
+    d[4] = c[3] ^ ROL16(c[0], 1);
+
+    // Theta, Rho, and Pi
+    b[ 0] = a[ 0] ^ d[0];
+    b[ 1] = ROL16(a[ 6] ^ d[1], 12);
+    b[ 2] = ROL16(a[12] ^ d[2], 11);
+    b[ 3] = ROL16(a[18] ^ d[3],  5);
+    b[ 4] = ROL16(a[24] ^ d[4], 14);
+    b[ 5] = ROL16(a[ 3] ^ d[3], 12);
+    b[ 6] = ROL16(a[ 9] ^ d[4],  4);
+    b[ 7] = ROL16(a[10] ^ d[0],  3);
+    b[ 8] = ROL16(a[16] ^ d[1], 13);
+    b[ 9] = ROL16(a[22] ^ d[2], 13);
+    b[10] = ROL16(a[ 1] ^ d[1],  1);
+    b[11] = ROL16(a[ 7] ^ d[2],  6);
+    b[12] = ROL16(a[13] ^ d[3],  9);
+    b[13] = ROL16(a[19] ^ d[4],  8);
+    b[14] = ROL16(a[20] ^ d[0],  2);
+    b[15] = ROL16(a[ 4] ^ d[4], 11);
+    b[16] = ROL16(a[ 5] ^ d[0],  4);
+    b[17] = ROL16(a[11] ^ d[1], 10);
+    b[18] = ROL16(a[17] ^ d[2], 15);
+    b[19] = ROL16(a[23] ^ d[3],  8);
+    b[20] = ROL16(a[ 2] ^ d[2], 14);
+    b[21] = ROL16(a[ 8] ^ d[3],  7);
+    b[22] = ROL16(a[14] ^ d[4],  7);
+    b[23] = ROL16(a[15] ^ d[0],  9);
+    b[24] = ROL16(a[21] ^ d[1],  2);
+
+    // Chi: non-linear layer (horizontally)
+    for (y = 0; y < NLANES; y += 5) {
+      a[y+0] = b[y+0] ^ (~b[y+1] & b[y+2]);
+      a[y+1] = b[y+1] ^ (~b[y+2] & b[y+3]);
+      a[y+2] = b[y+2] ^ (~b[y+3] & b[y+4]);
+      a[y+3] = b[y+3] ^ (~b[y+4] & b[y+0]);
+      a[y+4] = b[y+4] ^ (~b[y+0] & b[y+1]);
+    }
+
+    // Iota: addition of round constant
+    a[0] ^= RC[i];
+  }
+}
+
+
+// Print the 25 state-words of Keccak-p[400] in Hex format
+
+static void print_state(const tKeccakLane *a)
+{
+  UChar buffer[11*NLANES], byte;
+  int i, j, k, l = 0;
+
+  for (i = 0; i < 5; i++) {
+    for (j = 0; j < 5; j++) {
+      buffer[l++] = 'a';
+      buffer[l++] = i + 48;
+      buffer[l++] = j + 48;
+      buffer[l++] = ':';
+      buffer[l++] = ' ';
+      for (k = 3; k >= 0; k--) {
+        byte = (a[5*i+j] >> 4*k) & 0xf;
+        // replace 87 by 55 to get uppercase letters
+        buffer[l++] = byte + ((byte < 10) ? 48 : 87);
+      }
+      if (j < 4) {
+        buffer[l++] = ',';
+        buffer[l++] = ' ';
+      }
+    }
+    buffer[l++] = '\n';
+  }
+  buffer[l-1] = '\0';
+
+  printf("%s\n", buffer);
+}
+
+
+// Simple test function for the Keccak-p[400] permutation.
+
+void keccak400_test_perm(int rounds)
+{
+  tKeccakLane state[NLANES];
+  int i;
+
+  // 1st test: state is initialized with all-0 words
+
+  printf("Test 1 - C99 implementation:\n");
+  for (i = 0; i < NLANES; i++) state[i] = 0;
+  print_state(state);
+  keccak400_c99(state, rounds);  // permutation in C
+  print_state(state);
+
+#if defined(KECCAK400_ASSEMBLER)
+  printf("Test 1 - ASM implementation:\n");
+  for (i = 0; i < NLANES; i++) state[i] = 0;
+  print_state(state);
+  keccak400_asm(state, rounds);  // permutation in ASM
+  print_state(state);
+#endif
+
+  // 2nd test: state is initialized with byte-indeces
+
+  printf("Test 2 - C99 implementation (V2):\n");
+  for (i = 0; i < 2*NLANES; i++) ((uint8_t *) state)[i] = (uint8_t) i;
+  print_state(state);
+  keccak400_c99_V2(state, rounds);  // permutation in C
+  print_state(state);
+
+#if defined(KECCAK400_ASSEMBLER)
+  printf("Test 2 - ASM implementation:\n");
+  for (i = 0; i < 2*NLANES; i++) ((uint8_t *) state)[i] = (uint8_t) i;
+  print_state(state);
+  keccak400_asm(state, rounds);  // permutation in ASM
+  print_state(state);
+#endif
+
+  // Expected result for 20 rounds
+  // -----------------------------
+  // Test 1 - C99 implementation:
+  // a00: 0000, a01: 0000, a02: 0000, a03: 0000, a04: 0000
+  // a10: 0000, a11: 0000, a12: 0000, a13: 0000, a14: 0000
+  // a20: 0000, a21: 0000, a22: 0000, a23: 0000, a24: 0000
+  // a30: 0000, a31: 0000, a32: 0000, a33: 0000, a34: 0000
+  // a40: 0000, a41: 0000, a42: 0000, a43: 0000, a44: 0000
+  // a00: 09f5, a01: 40ac, a02: 0fa9, a03: 14f5, a04: e89f
+  // a10: eca0, a11: 5bd1, a12: 7870, a13: eff0, a14: bf8f
+  // a20: 0337, a21: 6052, a22: dc75, a23: 0ec9, a24: e776
+  // a30: 5246, a31: 59a1, a32: 5d81, a33: 6d95, a34: 6e14
+  // a40: 633e, a41: 58ee, a42: 71ff, a43: 714c, a44: b38e
+  // Test 1 - ASM implementation:
+  // a00: 0000, a01: 0000, a02: 0000, a03: 0000, a04: 0000
+  // a10: 0000, a11: 0000, a12: 0000, a13: 0000, a14: 0000
+  // a20: 0000, a21: 0000, a22: 0000, a23: 0000, a24: 0000
+  // a30: 0000, a31: 0000, a32: 0000, a33: 0000, a34: 0000
+  // a40: 0000, a41: 0000, a42: 0000, a43: 0000, a44: 0000
+  // a00: 09f5, a01: 40ac, a02: 0fa9, a03: 14f5, a04: e89f
+  // a10: eca0, a11: 5bd1, a12: 7870, a13: eff0, a14: bf8f
+  // a20: 0337, a21: 6052, a22: dc75, a23: 0ec9, a24: e776
+  // a30: 5246, a31: 59a1, a32: 5d81, a33: 6d95, a34: 6e14
+  // a40: 633e, a41: 58ee, a42: 71ff, a43: 714c, a44: b38e
+  // Test 2 - C99 implementation (V2):
+  // a00: 0100, a01: 0302, a02: 0504, a03: 0706, a04: 0908
+  // a10: 0b0a, a11: 0d0c, a12: 0f0e, a13: 1110, a14: 1312
+  // a20: 1514, a21: 1716, a22: 1918, a23: 1b1a, a24: 1d1c
+  // a30: 1f1e, a31: 2120, a32: 2322, a33: 2524, a34: 2726
+  // a40: 2928, a41: 2b2a, a42: 2d2c, a43: 2f2e, a44: 3130
+  // a00: 124f, a01: 0e06, a02: 2711, a03: 1e48, a04: df58
+  // a10: 9f3c, a11: 2eef, a12: af02, a13: fcf4, a14: d803
+  // a20: 9532, a21: 547a, a22: bcac, a23: 22be, a24: 4e51
+  // a30: cb5c, a31: 580f, a32: dd95, a33: 371f, a34: 3ae8
+  // a40: 4923, a41: 2c82, a42: 5cde, a43: 77aa, a44: 547d
+  // Test 2 - ASM implementation:
+  // a00: 0100, a01: 0302, a02: 0504, a03: 0706, a04: 0908
+  // a10: 0b0a, a11: 0d0c, a12: 0f0e, a13: 1110, a14: 1312
+  // a20: 1514, a21: 1716, a22: 1918, a23: 1b1a, a24: 1d1c
+  // a30: 1f1e, a31: 2120, a32: 2322, a33: 2524, a34: 2726
+  // a40: 2928, a41: 2b2a, a42: 2d2c, a43: 2f2e, a44: 3130
+  // a00: 124f, a01: 0e06, a02: 2711, a03: 1e48, a04: df58
+  // a10: 9f3c, a11: 2eef, a12: af02, a13: fcf4, a14: d803
+  // a20: 9532, a21: 547a, a22: bcac, a23: 22be, a24: 4e51
+  // a30: cb5c, a31: 580f, a32: dd95, a33: 371f, a34: 3ae8
+  // a40: 4923, a41: 2c82, a42: 5cde, a43: 77aa, a44: 547d
+}
+
+
+// Benchmark of the permutation versions on the same input. Each version is
+// executed `iter` times on the state of the 2nd test. The printed value is the
+// number of CYCLES() ticks per permutation call times 1000, followed by the
+// checksum of the final state (which is identical for all versions).
+
+void keccak400_bench_perm(int rounds, long iter)
+{
+  tKeccakLane state[NLANES];
+  unsigned long start, stop;
+  long n;
+  int i;
+
+  for (i = 0; i < 2*NLANES; i++) ((uint8_t *) state)[i] = (uint8_t) i;
+  start = CYCLES();
+  for (n = 0; n < iter; n++) keccak400_c99(state, rounds);
+  stop = CYCLES();
+  printf("keccak400_c99   : %llu (%04x)\n", TICKS1000(stop - start, iter),
+    (unsigned int) (state[0] ^ state[24]));
+
+  for (i = 0; i < 2*NLANES; i++) ((uint8_t *) state)[i] = (uint8_t) i;
+  start = CYCLES();
+  for (n = 0; n < iter; n++) keccak400_c99_V2(state, rounds);
+  stop = CYCLES();
+  printf("keccak400_c99_V2: %llu (%04x)\n", TICKS1000(stop - start, iter),
+    (unsigned int) (state[0] ^ state[24]));
+
+#if defined(KECCAK400_ASSEMBLER)
+  for (i = 0; i < 2*NLANES; i++) ((uint8_t *) state)[i] = (uint8_t) i;
+  start = CYCLES();
+  for (n = 0; n < iter; n++) keccak400_asm(state, rounds);
+  stop = CYCLES();
+  printf("keccak400_asm   : %llu (%04x)\n", TICKS1000(stop - start, iter),
+    (unsigned int) (state[0] ^ state[24]));
+#endif
+}
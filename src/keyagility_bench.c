@@ -0,0 +1,415 @@
+///////////////////////////////////////////////////////////////////////////////
+// keyagility_bench.c: Benchmark of key set-up and per-key amortized cost.   //
+// Version 1.0.0 (30-05-22), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// ------------------------------------------------------------------------- //
+// This source code is free software: you can redistribute it and/or modify  //
+// it under the terms of the GNU General Public License as published by the  //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This source code is distributed in the hope    //
+// that it will be useful, but WITHOUT ANY WARRANTY; without even the        //
+// implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  //
+// See the GNU General Public License for more details. You should have      //
+// received a copy of the GNU General Public License along with this source  //
+// code. If not, see <http://www.gnu.org/licenses/>.                         //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+typedef unsigned char UChar;
+typedef unsigned long long int ULLInt;
+
+
+// variants (same values as in ascon_aead.c, isap_aead.c, isapk_aead.c, and
+// elephant_aead.c)
+#define ASCON128  0
+#define ASCON128A 1
+#define ISAPA128A 0
+#define ISAPK128A 0
+#define DUMBO     0
+#define JUMBO     1
+#define DELIRIUM  2
+
+// maximum length of the benchmarked messages
+#define MAXMSG 1024
+
+// number of steps of the TinyJAMBU permutation (same as in tinyjambu_perm.c)
+#define NROUND1 128*5
+#define NROUND2 128*8
+
+// cycle counter for the benchmark; clock() by default, on a target without
+// an operating system it has to be re-defined to read a hardware timer
+#if !defined(CYCLES)
+#include <time.h>
+#define CYCLES() ((unsigned long) clock())
+#endif
+
+
+// Key objects of Elephant and GIFT-COFB. Their layout is private to
+// elephant_aead.c and giftcofb_aead.c; they are allocated with the size that
+// elephant_keysize and giftcofb_keysize return.
+
+typedef struct ElephantKey ElephantKey;
+typedef struct GiftCofbKey GiftCofbKey;
+
+
+extern void ascon_aead_encrypt(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant);
+extern void isap_aead_encrypt(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant);
+extern void isapk_aead_encrypt(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant);
+extern void elephant_aead_encrypt(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant);
+extern size_t elephant_keysize(void);
+extern void elephant_setkey(ElephantKey *dk, const UChar *key, int variant);
+extern void elephant_aead_encrypt_dk(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  ElephantKey *dk);
+extern void elephant_aead_encrypt_par(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key, int variant);
+extern size_t giftcofb_keysize(void);
+extern void giftcofb_setkey(GiftCofbKey *gk, const UChar *key);
+extern void giftcofb_aead_encrypt(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  const GiftCofbKey *gk);
+extern void gift128f_grk_c99_V1(uint32_t *rkey, const uint8_t *key);
+extern void gift128f_grk_c99_V2(uint32_t *rkey, const uint8_t *key);
+extern void gift128f_enc_c99(uint8_t *ctxt, const uint8_t *ptxt,
+  const uint32_t *rkey);
+extern void gift128f_enc_otf_c99(uint8_t *ctxt, const uint8_t *ptxt,
+  const uint8_t *key);
+extern void skinny128384p_enc_c99_V2(uint8_t *ctext, const uint8_t *ptext,
+  const uint32_t *rtk1, const uint32_t *rtk2_3);
+extern void state_update_c99(uint32_t *state, const uint32_t *key,
+  int steps);
+extern void grain_aead_encrypt(UChar *c, UChar *tag, const UChar *m,
+  size_t mlen, const UChar *ad, size_t adlen, const UChar *npub,
+  const UChar *key);
+
+#if (defined(__MSP430__) || defined(__ICC430__))
+extern void gift128f_grk_msp(uint32_t *rkey, const uint8_t *key);
+extern void gift128f_enc_msp(uint8_t *ctxt, const uint8_t *ptxt,
+  const uint32_t *rkey);
+extern void gift128f_enc_otf_msp(uint8_t *ctxt, const uint8_t *ptxt,
+  const uint8_t *key);
+extern void state_update_msp(uint32_t *state, const uint32_t *key,
+  int steps);
+#define state_update(state, key, steps) \
+  state_update_msp((state), (key), (steps))
+#else
+#define state_update(state, key, steps) \
+  state_update_c99((state), (key), (steps))
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+////////////////// OPERATIONS THAT ARE MEASURED PER ALGORITHM /////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Every algorithm is benchmarked through (up to) three operations with the
+// same signature: `setup` computes what can be precomputed from the key alone
+// (NULL if there is nothing to precompute), `msg` processes one message with
+// the precomputed key material, and `nopre` processes one message without it,
+// i.e. it either re-derives the key material on the fly or (if there is no
+// such code path) runs `setup` and `msg` back to back. All operations work on
+// the static buffers below, and the message length is `mlen`.
+
+static UChar key[16], npub[16], buf[MAXMSG], tag[16];
+static size_t mlen;
+static int variant;
+static ElephantKey *dk;
+static GiftCofbKey *gk;
+static uint32_t rkey[80], rtk1[64], rtk2_3[160];
+static uint32_t jstate[4], jkey[4], jinit[4];
+
+
+static void ascon_msg(void)
+{
+  ascon_aead_encrypt(buf, tag, buf, mlen, NULL, 0, npub, key, variant);
+}
+
+
+static void isap_msg(void)
+{
+  isap_aead_encrypt(buf, tag, buf, mlen, NULL, 0, npub, key, ISAPA128A);
+}
+
+
+static void isapk_msg(void)
+{
+  isapk_aead_encrypt(buf, tag, buf, mlen, NULL, 0, npub, key, ISAPK128A);
+}
+
+
+// Elephant is measured on the key-context path in all three operations, i.e.
+// `nopre` sets up a new key context for every message.
+
+static void elephant_setup(void)
+{
+  elephant_setkey(dk, key, variant);
+}
+
+
+static void elephant_msg(void)
+{
+  elephant_aead_encrypt_dk(buf, tag, buf, mlen, NULL, 0, npub, dk);
+}
+
+
+static void elephant_nopre(void)
+{
+  elephant_aead_encrypt_par(buf, tag, buf, mlen, NULL, 0, npub, key,
+    variant);
+}
+
+
+static void giftcofb_setup(void)
+{
+  giftcofb_setkey(gk, key);
+}
+
+
+static void giftcofb_msg(void)
+{
+  giftcofb_aead_encrypt(buf, tag, buf, mlen, NULL, 0, npub, gk);
+}
+
+
+static void giftcofb_nopre(void)
+{
+  giftcofb_setkey(gk, key);
+  giftcofb_aead_encrypt(buf, tag, buf, mlen, NULL, 0, npub, gk);
+}
+
+
+// GIFT-128 is measured on the level of a single 16-byte block; the round-keys
+// are either precomputed (gift128f_grk_*) or derived on the fly for each
+// block (gift128f_enc_otf_*).
+
+static void gift128_setup_V1(void)
+{
+  gift128f_grk_c99_V1(rkey, key);
+}
+
+
+static void gift128_setup_V2(void)
+{
+  gift128f_grk_c99_V2(rkey, key);
+}
+
+
+static void gift128_msg(void)
+{
+  gift128f_enc_c99(buf, buf, rkey);
+}
+
+
+static void gift128_nopre(void)
+{
+  gift128f_enc_otf_c99(buf, buf, key);
+}
+
+
+#if (defined(__MSP430__) || defined(__ICC430__))
+
+static void gift128_setup_msp(void)
+{
+  gift128f_grk_msp(rkey, key);
+}
+
+
+static void gift128_msg_msp(void)
+{
+  gift128f_enc_msp(buf, buf, rkey);
+}
+
+
+static void gift128_nopre_msp(void)
+{
+  gift128f_enc_otf_msp(buf, buf, key);
+}
+
+#endif
+
+
+// Skinny-128-384+ is measured on the level of a single block. This source
+// tree contains no tweakey schedule (the round-tweakeys are an input of the
+// cipher), so there is no set-up to measure.
+
+static void skinny_msg(void)
+{
+  skinny128384p_enc_c99_V2(buf, buf, rtk1, rtk2_3);
+}
+
+
+// TinyJAMBU-128 is measured through the state-updates of its AEAD mode: the
+// key set-up (P1024 on the all-zero state) depends only on the key and can
+// be precomputed, whereas the nonce set-up (3 times P640), the encryption of
+// the message (P1024 per 32-bit block), and the finalization (P1024 and P640)
+// have to be executed for every message.
+
+static void tinyjambu_setup(void)
+{
+  memset(jinit, 0, sizeof(jinit));
+  state_update(jinit, jkey, NROUND2);
+}
+
+
+static void tinyjambu_msg(void)
+{
+  size_t i;
+
+  memcpy(jstate, jinit, sizeof(jstate));
+  for (i = 0; i < 3; i++) state_update(jstate, jkey, NROUND1);
+  for (i = 0; i < mlen; i += 4) state_update(jstate, jkey, NROUND2);
+  state_update(jstate, jkey, NROUND2);
+  state_update(jstate, jkey, NROUND1);
+}
+
+
+static void tinyjambu_nopre(void)
+{
+  tinyjambu_setup();
+  tinyjambu_msg();
+}
+
+
+// The initialization of Grain-128AEADv2 mixes key and nonce from the first
+// clock, so nothing can be precomputed.
+
+static void grain_msg(void)
+{
+  grain_aead_encrypt(buf, tag, buf, mlen, NULL, 0, npub, key);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+/////////////////////////// BENCHMARK OF KEY AGILITY //////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Number of CYCLES() ticks (times 1000) of one execution of operation `op`.
+// The result is computed and returned as 64-bit value since one execution of
+// Elephant with a 1 kB message takes several million ticks on MSP430, i.e.
+// the product with 1000 does not fit into an `unsigned long`.
+
+static ULLInt measure(void (*op)(void), long iter)
+{
+  unsigned long start, stop;
+  long n;
+
+  start = CYCLES();
+  for (n = 0; n < iter; n++) op();
+  stop = CYCLES();
+
+  return (1000*((ULLInt) (stop - start)))/iter;
+}
+
+
+// Print one line of the benchmark: the key set-up, the latency of the first
+// message under a new key (set-up plus one message), the cost per message
+// with precomputed key material, the amortized cost per message when `nmsg`
+// messages are processed under one key, and the break-even point, i.e. the
+// smallest number of messages per key for which precomputing the key material
+// is faster than the `nopre` path. The latter is "-" when there is nothing to
+// precompute and "never" when the `nopre` path is not slower than `msg`. The
+// set-up is executed once before it is measured so that one-time costs (e.g.
+// the jump-ahead tables of Elephant) are not included.
+
+static void bench_row(const char *name, void (*setup)(void),
+  void (*msg)(void), void (*nopre)(void), int nmsg, long iter)
+{
+  ULLInt tsetup = 0, tmsg, tnopre;
+  char be[24];
+
+  if (setup != NULL) {
+    setup();  // warm-up
+    tsetup = measure(setup, iter);
+    setup();  // key material for `msg`
+  }
+  tmsg = measure(msg, iter);
+  tnopre = (nopre != NULL) ? measure(nopre, iter) : tmsg;
+
+  if (setup == NULL) sprintf(be, "-");
+  else if (tnopre <= tmsg) sprintf(be, "never");
+  else sprintf(be, "%llu", tsetup/(tnopre - tmsg) + 1);
+
+  printf("%-18s %9llu %9llu %9llu %9llu %9llu %6s\n", name, tsetup,
+    tsetup + tmsg, tmsg, tnopre, (tsetup + nmsg*tmsg)/nmsg, be);
+}
+
+
+// Benchmark of key set-up, first-message latency, and amortized cost over
+// `nmsg` messages of length `len` (at most MAXMSG bytes) per key for all keyed
+// algorithms of this source tree. GIFT-128 and Skinny-128-384+ are measured
+// per 16-byte block. PHOTON-Beetle, Schwaemm and Xoodyak are not included
+// since their only key set-up is the loading of the key into the state.
+
+void keyagility_bench(size_t len, int nmsg, long iter)
+{
+  int i;
+
+  dk = (ElephantKey *) malloc(elephant_keysize());
+  gk = (GiftCofbKey *) malloc(giftcofb_keysize());
+  if (dk == NULL || gk == NULL) {
+    printf("Out of memory\n");
+    free(dk); free(gk);
+    return;
+  }
+  for (i = 0; i < 16; i++) key[i] = npub[i] = (UChar) i;
+  for (i = 0; i < MAXMSG; i++) buf[i] = (UChar) i;
+  for (i = 0; i < 256; i++) ((uint8_t *) rtk1)[i] = (uint8_t) i;
+  for (i = 0; i < 640; i++) ((uint8_t *) rtk2_3)[i] = (uint8_t) i;
+  memcpy(jkey, key, 16);
+  mlen = (len < MAXMSG) ? len : MAXMSG;
+
+  printf("%u-byte messages, amortized over %i messages per key\n",
+    (unsigned) mlen, nmsg);
+  printf("%-18s %9s %9s %9s %9s %9s %6s\n", "algorithm", "key setup",
+    "1st msg", "msg", "no precmp", "amortized", "b-even");
+
+  variant = ASCON128;
+  bench_row("ASCON128", NULL, ascon_msg, NULL, nmsg, iter);
+  variant = ASCON128A;
+  bench_row("ASCON128a", NULL, ascon_msg, NULL, nmsg, iter);
+  bench_row("ISAP-A-128A", NULL, isap_msg, NULL, nmsg, iter);
+  bench_row("ISAP-K-128A", NULL, isapk_msg, NULL, nmsg, iter);
+  variant = DUMBO;
+  bench_row("Elephant Dumbo", elephant_setup, elephant_msg, elephant_nopre,
+    nmsg, iter);
+  variant = JUMBO;
+  bench_row("Elephant Jumbo", elephant_setup, elephant_msg, elephant_nopre,
+    nmsg, iter);
+  variant = DELIRIUM;
+  bench_row("Elephant Delirium", elephant_setup, elephant_msg,
+    elephant_nopre, nmsg, iter);
+  bench_row("GIFT-COFB", giftcofb_setup, giftcofb_msg, giftcofb_nopre,
+    nmsg, iter);
+  bench_row("GIFT-128 (V1)", gift128_setup_V1, gift128_msg, gift128_nopre,
+    nmsg, iter);
+  bench_row("GIFT-128 (V2)", gift128_setup_V2, gift128_msg, gift128_nopre,
+    nmsg, iter);
+#if (defined(__MSP430__) || defined(__ICC430__))
+  bench_row("GIFT-128 (ASM)", gift128_setup_msp, gift128_msg_msp,
+    gift128_nopre_msp, nmsg, iter);
+#endif
+  bench_row("Skinny-128-384+", NULL, skinny_msg, NULL, nmsg, iter);
+  bench_row("TinyJAMBU-128", tinyjambu_setup, tinyjambu_msg,
+    tinyjambu_nopre, nmsg, iter);
+  bench_row("Grain-128AEADv2", NULL, grain_msg, NULL, nmsg, iter);
+
+  free(dk);
+  free(gk);
+}